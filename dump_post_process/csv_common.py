@@ -4,6 +4,8 @@
 
 import os
 import csv
+import gzip
+import io
 
 KEY_ALTERNATIVES = [
 	('start_time',  'Tx_Start_Time'),
@@ -13,10 +15,59 @@ KEY_ALTERNATIVES = [
 	('packet',      'Packet'),
 ]
 
+GZIP_MAGIC = b'\x1f\x8b'
+
+def open_text(f):
+	"""
+	Open a (possibly gzip compressed, as produced with -dump_compress)
+	dump file for reading as text.
+	f may be a file name, or an already open text or binary file
+	"""
+	if not hasattr(f, 'read'):
+		with open(f, 'rb') as probe:
+			compressed = probe.read(2) == GZIP_MAGIC
+		if compressed:
+			return gzip.open(f, 'rt', newline='')
+		return open(f, newline='')
+	raw = getattr(f, 'buffer', f)
+	if hasattr(raw, 'peek') and raw.peek(2)[:2] == GZIP_MAGIC:
+		return io.TextIOWrapper(gzip.GzipFile(fileobj=raw, mode='rb'), newline='')
+	if raw is f and not isinstance(f, io.TextIOBase):
+		return io.TextIOWrapper(f, newline='')
+	return f
+
+def read_index(filename):
+	"""
+	Read the time index of a dump file (<filename>.idx, as produced with
+	-dump_idx) as a list of (time, offset, record) tuples.
+	Returns an empty list if the dump has no index
+	"""
+	index = []
+	try:
+		with open(filename + '.idx', newline='') as f:
+			reader = csv.reader(f)
+			next(reader, None)
+			for line in reader:
+				index.append(tuple(int(v) for v in line[:3]))
+	except OSError:
+		pass
+	return index
+
+def index_offset(filename, time):
+	"""
+	Byte offset of the dump file from which to read to get all its records
+	with a time >= time (0 if it has no index)
+	"""
+	offset = 0
+	for (t, off, _) in read_index(filename):
+		if t > time:
+			break
+		offset = off
+	return offset
+
 class CSVFile:
 	def __init__(self, f):
-		if not hasattr(f, 'read'):
-			f = open(f, newline='')
+		f = open_text(f)
 		self.file = f
 		self.reader = csv.reader(self.file, delimiter=',', lineterminator='\n')
 		try:
@@ -28,6 +79,39 @@ class CSVFile:
 			if not key in headers and alt in headers:
 				headers[headers.index(alt)] = key
 		self.headers = headers
+		# Multiplexed files (with a leading device column) are not in time order
+		self.mux = headers[:1] == ['dev']
+		# Main time column (the first one, after the device in multiplexed files)
+		self.time_key = headers[1] if self.mux else (headers[0] if headers else None)
+
+	def seek_time(self, time):
+		"""
+		Skip (using the dump time index, if there is one) to a point before
+		the first record with a time >= time
+		"""
+		name = getattr(self.file, 'name', None)
+		if not isinstance(name, str):
+			return
+		# (Compressed dumps are never indexed)
+		offset = index_offset(name, time)
+		if offset > 0:
+			self.file.seek(offset)
+
+	def time_range(self, start, end):
+		"""
+		Iterate over the rows whose main time is in [start, end]
+		(Per device files are in time order, so reading stops after end.
+		Multiplexed ones are not, so they are read till their end)
+		"""
+		self.seek_time(start)
+		for row in self:
+			if row is None:
+				continue
+			t = int(row[self.time_key])
+			if t > end and not self.mux:
+				break
+			if start <= t <= end:
+				yield row
 
 	def __del__(self):
 		self.file.close()
@@ -51,13 +135,14 @@ class CSVFile:
 			except IndexError: # The last line may be corrupted, so let's end if we find a corrupted one
 				print("Input file %s truncated mid line, ignoring line"%self.file.name) 
 				return None
-		row['start_time'] = int(row['start_time'], 10)
+		if 'start_time' in row:
+			row['start_time'] = int(row['start_time'], 10)
 		return row
 
 def open_input(filename):
 	try:
 		mtime = os.path.getmtime(filename)
-		return (mtime, open(filename, mode='r', newline=''))
+		return (mtime, open_text(filename))
 	except OSError as e:
 		raise argparse.ArgumentTypeError(
 				"can't open '{}': {}".format(filename, e))
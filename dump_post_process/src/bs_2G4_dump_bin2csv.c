@@ -0,0 +1,141 @@
+/*
+ * Copyright 2026 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * Convert a binary dump file (see p2G4_dump_bin.h) into the same CSV file
+ * the Phy would have produced
+ *
+ * Usage: bs_2G4_dump_bin2csv [-v1] [-sparse] [-from <time>] [-to <time>] <input.bin> [<output.csv>]
+ *  -v1 : For Tx and Rx files, produce the v1 format (Tx/Rx) instead of v2
+ *  -sparse : For ModemRx files, produce the sparse format (ModemRxSparse)
+ *  -from/-to <time> : Only convert the records whose time (first column) is in
+ *        this range (in us). If the dump has a time index (<input.bin>.idx), the
+ *        records before <from> are skipped without reading them. Per device
+ *        files are in time order, so reading stops after <to>. Multiplexed
+ *        ones are not, so they are read till their end
+ * If no output is given, it is written to stdout
+ * Multiplexed files (-dump_mux) produce the multiplexed CSV (with a device column)
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bs_types.h"
+#include "bs_tracing.h"
+#include "bs_oswrap.h"
+#include "p2G4_dump_rec.h"
+#include "p2G4_dump_format.h"
+#include "p2G4_dump_bin.h"
+#include "p2G4_dump_idx.h"
+
+static void usage(const char *argv0) {
+  fprintf(stderr, "Usage: %s [-v1] [-sparse] [-from <time>] [-to <time>] <input.bin> [<output.csv>]\n", argv0);
+  exit(1);
+}
+
+int main(int argc, char *argv[]) {
+  const char *in_name = NULL, *out_name = NULL;
+  bool v1 = false, sparse = false;
+  bs_time_t from = 0, to = TIME_NEVER;
+
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-v1") == 0) {
+      v1 = true;
+    } else if (strcmp(argv[i], "-sparse") == 0) {
+      sparse = true;
+    } else if ((strcmp(argv[i], "-from") == 0) && (i + 1 < argc)) {
+      from = strtoull(argv[++i], NULL, 10);
+    } else if ((strcmp(argv[i], "-to") == 0) && (i + 1 < argc)) {
+      to = strtoull(argv[++i], NULL, 10);
+    } else if (in_name == NULL) {
+      in_name = argv[i];
+    } else if (out_name == NULL) {
+      out_name = argv[i];
+    } else {
+      usage(argv[0]);
+    }
+  }
+  if (in_name == NULL) {
+    usage(argv[0]);
+  }
+
+  dbin_reader_t *r = dbin_open_read(in_name);
+  if (r == NULL) {
+    bs_trace_error_line("Could not open %s as a binary dump file\n", in_name);
+  }
+
+  p2G4_dump_stream_t stream = dbin_header(r)->stream;
+  p2G4_dump_file_t file;
+
+  switch (stream) {
+  case P2G4_DS_TX:
+    file = v1 ? P2G4_DF_TXV1 : P2G4_DF_TXV2;
+    break;
+  case P2G4_DS_RX:
+    file = v1 ? P2G4_DF_RXV1 : P2G4_DF_RXV2;
+    break;
+  case P2G4_DS_RSSI:
+    file = P2G4_DF_RSSI;
+    break;
+  case P2G4_DS_CCA:
+    file = P2G4_DF_CCA;
+    break;
+  case P2G4_DS_MODEMRX:
+    file = sparse ? P2G4_DF_MODEMRXS : P2G4_DF_MODEMRX;
+    break;
+  default:
+    bs_trace_error_line("%s: unknown stream %u\n", in_name, stream);
+    return 1;
+  }
+
+  FILE *out = stdout;
+  if (out_name != NULL) {
+    out = bs_fopen(out_name, "w");
+  }
+
+  /* Multiplexed files get a leading device column */
+  bool mux = (dbin_header(r)->dev == P2G4_DBIN_ALL_DEVS);
+
+  if (mux) {
+    fputs("dev,", out);
+  }
+  fputs(dfmt_heading[file], out);
+
+  size_t line_size = 4096;
+  char *line = bs_malloc(line_size);
+  const p2G4_drec_hdr_t *rec;
+  const void *var;
+
+  uint64_t offset;
+  if ((from > 0) && didx_lookup(in_name, from, &offset) && (offset > dbin_tell(r))) {
+    dbin_seek(r, offset);
+  }
+
+  while ((rec = dbin_next(r, &var)) != NULL) {
+    if ((rec->time > to) && !mux) {
+      break; /* Per device files are in time order, all that follows is after <to> */
+    }
+    if ((rec->time < from) || (rec->time > to)) {
+      continue;
+    }
+    int len = dfmt_record(line, line_size, file, rec, var, NULL);
+    if ((size_t)len >= line_size) {
+      line_size = 2*len + 1;
+      line = bs_realloc(line, line_size);
+      dfmt_record(line, line_size, file, rec, var, NULL);
+    }
+    if (mux) {
+      fprintf(out, "%u,", rec->dev);
+    }
+    fprintf(out, "%s\n", line);
+  }
+
+  free(line);
+  dbin_close(r);
+  if (out != stdout) {
+    fclose(out);
+  }
+  return 0;
+}
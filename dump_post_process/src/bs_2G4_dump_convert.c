@@ -0,0 +1,652 @@
+/*
+ * Copyright 2026 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * Merge the Tx CSV dumps of any number of devices, in time order, into a
+ * pcap, pcapng, 802.15.4 pcap, or Ellisys (bttrp) capture.
+ * Equivalent to the csv2pcap, csv2pcapng, csv2pcap_15.4.py and csv2bttrp
+ * scripts, but fast enough for very large dumps: the inputs are memory
+ * mapped, only the needed columns are parsed, and the inputs are merged with
+ * a heap.
+ *
+ * Usage: bs_2G4_dump_convert -f <format> [-er] [-s <snaplen>] [-from <time>] [-to <time>]
+ *                            [-o <output>] <input.csv>...
+ *  -f <format> : pcap (BLE), pcapng (BLE and 802.15.4), pcap154 (802.15.4) or bttrp (BLE)
+ *  -er : Offset the timestamps by the time the simulation was run (the
+ *        inputs modification time). By default they are the simulated time
+ *  -s <snaplen> : Maximum length of captured packets (by default 512)
+ *  -from/-to <time> : Only convert the packets which start in this range (in us).
+ *        For the inputs with a time index (<input.csv>.idx), the packets
+ *        before <from> are skipped without parsing them. Per device inputs
+ *        are in time order, so they are not read after <to>; multiplexed
+ *        inputs (-dump_mux) are not, so they are read till their end
+ * The inputs are Tx (v1) or Txv2 CSV files. The timestamps are the start of
+ * the packet. If no output is given, it is written to stdout
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "bs_types.h"
+#include "bs_tracing.h"
+#include "bs_oswrap.h"
+#include "bs_utils.h"
+#include "p2G4_dump_idx.h"
+
+#define DEFAULT_SNAPLEN 512
+#define OUT_BUF_SIZE (4*1024*1024)
+/*
+ * Txv2 files are indexed by the Tx start, which is before the packet start
+ * (by the preamble and address) by less than this (in us)
+ */
+#define TXV2_IDX_MARGIN 1000
+
+/* BabbleSim modulations (see bs_pc_2G4_modulations.h) */
+#define MOD_BLE       0x10
+#define MOD_BLE2M     0x20
+#define MOD_BLE_CODED 0x50
+#define MOD_154       0x100
+
+/* LE PHDR flags */
+#define PHDR_SIGNAL_POWER 0x0002
+#define PHDR_PHY_2M       (1 << 14)
+#define PHDR_PHY_CODED    (2 << 14)
+
+typedef enum { OUT_PCAP, OUT_PCAPNG, OUT_PCAP154, OUT_BTTRP } out_format_t;
+
+/* Columns we need */
+enum { C_TIME = 0, C_FREQ, C_ADDR, C_MOD, C_POWER, C_SIZE, C_PACKET, C_N };
+
+typedef struct {
+  const char *ptr;
+  size_t len;
+} field_t;
+
+/* One Tx (one CSV line) */
+typedef struct {
+  uint64_t time;
+  field_t f[C_N];
+} row_t;
+
+typedef struct {
+  const char *name;
+  const char *map;
+  size_t map_size;
+  size_t size; /* Size to parse */
+  size_t pos;
+  int col[C_N];
+  int n_cols; /* Columns we need to reach */
+  bool mux;   /* Multiplexed file (with a dev column), not in time order */
+  row_t row;  /* Current row */
+} input_t;
+
+static input_t *inputs;
+static uint n_inputs;
+/* Heap of inputs (indexes) by their current row time */
+static uint *heap;
+static uint heap_len;
+
+static FILE *out;
+static out_format_t format;
+static uint snaplen = DEFAULT_SNAPLEN;
+static uint8_t *packet_buf;
+static uint64_t from = 0, to = TIME_NEVER;
+
+static void usage(const char *argv0) {
+  fprintf(stderr, "Usage: %s -f pcap|pcapng|pcap154|bttrp [-er] [-s <snaplen>] "
+                  "[-from <time>] [-to <time>] [-o <output>] <input.csv>...\n", argv0);
+  exit(1);
+}
+
+/**
+ * Find the index of the column <name> in the heading line
+ */
+static int find_col(const char *heading, size_t len, const char *name) {
+  size_t name_len = strlen(name);
+  const char *p = heading, *end = heading + len;
+  int col = 0;
+
+  while (p < end) {
+    const char *comma = memchr(p, ',', end - p);
+    const char *f_end = comma ? comma : end;
+    while ((p < f_end) && (*p == ' ')) {
+      p++;
+    }
+    size_t f_len = f_end - p;
+    while ((f_len > 0) && ((p[f_len - 1] == ' ') || (p[f_len - 1] == '\r'))) {
+      f_len--;
+    }
+    if ((f_len == name_len) && (memcmp(p, name, name_len) == 0)) {
+      return col;
+    }
+    col++;
+    p = f_end + 1;
+  }
+  return -1;
+}
+
+static uint64_t parse_u64(field_t f, int base) {
+  char tmp[32];
+  size_t len = BS_MIN(f.len, sizeof(tmp) - 1);
+  memcpy(tmp, f.ptr, len);
+  tmp[len] = 0;
+  return strtoull(tmp, NULL, base);
+}
+
+static double parse_d(field_t f) {
+  char tmp[32];
+  size_t len = BS_MIN(f.len, sizeof(tmp) - 1);
+  memcpy(tmp, f.ptr, len);
+  tmp[len] = 0;
+  return strtod(tmp, NULL);
+}
+
+/**
+ * Parse the next line of an input into in->row
+ * Returns false when there is no more (or the rest is corrupted)
+ */
+static bool next_row(input_t *in) {
+  while (in->pos < in->size) {
+    const char *line = &in->map[in->pos];
+    const char *end = memchr(line, '\n', in->size - in->pos);
+    if (end == NULL) {
+      end = &in->map[in->size];
+    }
+    in->pos = end - in->map + 1;
+    if (end == line) { /* Empty line */
+      continue;
+    }
+
+    const char *p = line;
+    int col = 0;
+    int found = 0;
+    while ((p <= end) && (col < in->n_cols)) {
+      const char *comma = memchr(p, ',', end - p);
+      const char *f_end = comma ? comma : end;
+      for (int c = 0; c < C_N; c++) {
+        if (in->col[c] == col) {
+          in->row.f[c].ptr = p;
+          in->row.f[c].len = f_end - p;
+          found++;
+        }
+      }
+      col++;
+      if (comma == NULL) {
+        break;
+      }
+      p = comma + 1;
+    }
+    if (found < C_N) {
+      bs_trace_warning_line("%s: corrupted line, ignoring the rest of the file\n", in->name);
+      in->pos = in->size;
+      return false;
+    }
+    in->row.time = parse_u64(in->row.f[C_TIME], 10);
+    return true;
+  }
+  return false;
+}
+
+static void open_input(input_t *in, const char *name) {
+  struct stat st;
+  int fd = open(name, O_RDONLY);
+
+  in->name = name;
+  if ((fd < 0) || (fstat(fd, &st) != 0)) {
+    bs_trace_error_line("Could not open %s\n", name);
+  }
+  in->size = in->map_size = st.st_size;
+  in->pos = 0;
+  in->map = NULL;
+  if (in->size > 0) {
+    in->map = mmap(NULL, in->size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (in->map == MAP_FAILED) {
+      bs_trace_error_line("Could not map %s\n", name);
+    }
+    posix_madvise((void *)in->map, in->size, POSIX_MADV_SEQUENTIAL);
+  }
+  close(fd);
+
+  if ((in->size >= 2) && ((uint8_t)in->map[0] == 0x1F) && ((uint8_t)in->map[1] == 0x8B)) {
+    bs_trace_error_line("%s is compressed, decompress it first\n", name);
+  }
+
+  const char *end = in->size ? memchr(in->map, '\n', in->size) : NULL;
+  if (end == NULL) {
+    bs_trace_warning_line("%s is empty\n", name);
+    in->size = 0;
+    return;
+  }
+  size_t len = end - in->map;
+  in->pos = len + 1;
+  in->mux = (find_col(in->map, len, "dev") == 0);
+
+  static const char *const names[C_N][2] = {
+    { "start_time", "start_packet_time" }, /* Tx (v1), Txv2 */
+    { "center_freq", NULL },
+    { "phy_address", NULL },
+    { "modulation", NULL },
+    { "power_level", NULL },
+    { "packet_size", NULL },
+    { "packet", NULL },
+  };
+  bool v2 = false;
+  in->n_cols = 0;
+  for (int c = 0; c < C_N; c++) {
+    in->col[c] = find_col(in->map, len, names[c][0]);
+    if ((in->col[c] < 0) && (names[c][1] != NULL)) {
+      in->col[c] = find_col(in->map, len, names[c][1]);
+      v2 = true;
+    }
+    if (in->col[c] < 0) {
+      bs_trace_error_line("%s does not look like a Tx dump (no %s column)\n", name, names[c][0]);
+    }
+    in->n_cols = BS_MAX(in->n_cols, in->col[c] + 1);
+  }
+
+  uint64_t idx_time = from;
+  uint64_t offset;
+  if (v2) {
+    idx_time = (from > TXV2_IDX_MARGIN) ? from - TXV2_IDX_MARGIN : 0;
+  }
+  if ((idx_time > 0) && didx_lookup(name, idx_time, &offset)
+      && (offset > in->pos) && (offset < in->size)) {
+    in->pos = offset;
+  }
+}
+
+static inline bool heap_less(uint a, uint b) {
+  if (inputs[a].row.time != inputs[b].row.time) {
+    return inputs[a].row.time < inputs[b].row.time;
+  }
+  return a < b;
+}
+
+static void heap_down(uint i) {
+  while (true) {
+    uint l = 2*i + 1, r = l + 1, m = i;
+    if ((l < heap_len) && heap_less(heap[l], heap[m])) {
+      m = l;
+    }
+    if ((r < heap_len) && heap_less(heap[r], heap[m])) {
+      m = r;
+    }
+    if (m == i) {
+      return;
+    }
+    uint t = heap[i]; heap[i] = heap[m]; heap[m] = t;
+    i = m;
+  }
+}
+
+static void heap_up(uint i) {
+  while (i > 0) {
+    uint p = (i - 1) / 2;
+    if (!heap_less(heap[i], heap[p])) {
+      return;
+    }
+    uint t = heap[i]; heap[i] = heap[p]; heap[p] = t;
+    i = p;
+  }
+}
+
+static inline int hex_val(char c) {
+  if ((c >= '0') && (c <= '9')) {
+    return c - '0';
+  } else if ((c >= 'A') && (c <= 'F')) {
+    return c - 'A' + 10;
+  } else if ((c >= 'a') && (c <= 'f')) {
+    return c - 'a' + 10;
+  }
+  return -1;
+}
+
+/**
+ * Decode the packet hex dump (bytes separated by spaces) into buf
+ * Returns the number of complete bytes
+ */
+static uint decode_packet(field_t f, uint8_t *buf, uint max) {
+  uint n = 0;
+  for (size_t i = 0; (i + 1 < f.len) && (n < max); ) {
+    int h = hex_val(f.ptr[i]), l = hex_val(f.ptr[i + 1]);
+    if ((h < 0) || (l < 0)) {
+      if (f.ptr[i] == ' ') {
+        i++;
+        continue;
+      }
+      break;
+    }
+    buf[n++] = (h << 4) | l;
+    i += 2;
+  }
+  return n;
+}
+
+static void put_u16(uint16_t v) {
+  fwrite(&v, 2, 1, out);
+}
+static void put_u32(uint32_t v) {
+  fwrite(&v, 4, 1, out);
+}
+
+static void write_header(void) {
+  switch (format) {
+  case OUT_PCAP:
+  case OUT_PCAP154:
+    put_u32(0xA1B2C3D4);
+    put_u16(2);
+    put_u16(4);
+    put_u32(0); /* thiszone */
+    put_u32(0); /* sigfigs */
+    put_u32(snaplen);
+    put_u32(format == OUT_PCAP ? 256 : 215); /* BLUETOOTH_LE_LL_WITH_PHDR / IEEE802_15_4_NONASK_PHY */
+    break;
+  case OUT_PCAPNG:
+    /* SHB */
+    put_u32(0x0A0D0D0A);
+    put_u32(28);
+    put_u32(0x1A2B3C4D);
+    put_u16(1);
+    put_u16(0);
+    put_u32(0xFFFFFFFF);
+    put_u32(0xFFFFFFFF);
+    put_u32(28);
+    /* IDBs: #0 BLE, #1 802.15.4, us resolution */
+    for (int i = 0; i < 2; i++) {
+      put_u32(1);
+      put_u32(32);
+      put_u16(i == 0 ? 256 : 215);
+      put_u16(0);
+      put_u32(snaplen);
+      put_u16(9); /* if_tsresol */
+      put_u16(1);
+      put_u32(6);
+      put_u32(0); /* opt_endofopt */
+      put_u32(32);
+    }
+    break;
+  case OUT_BTTRP:
+    fputs("FileFormat:Bluetooth\n"
+          "                version=1.0\n"
+          "\n"
+          "ItemFormat:LE version=1.1\n", out);
+    break;
+  }
+}
+
+static inline bool is_154(uint mod) {
+  return mod == MOD_154;
+}
+
+/**
+ * BLE channel index of a row center frequency (in MHz, either offset from
+ * 2400MHz or absolute). As the scripts, fail on frequencies outside the band
+ */
+static int rf_channel(const row_t *row) {
+  double freq = parse_d(row->f[C_FREQ]);
+
+  if ((freq >= 1.0) && (freq < 81.0)) {
+    return (freq - 1.0) / 2;
+  } else if ((freq >= 2401.0) && (freq < 2481.0)) {
+    return (freq - 2401.0) / 2;
+  }
+  bs_trace_error_line("Packet at %"PRIu64" has an out of range center frequency (%.*s)\n",
+                      row->time, (int)row->f[C_FREQ].len, row->f[C_FREQ].ptr);
+  return 0;
+}
+
+/**
+ * Write a pcap/pcapng packet record
+ */
+static void write_packet(uint64_t ts, const row_t *row, const uint8_t *data, uint size,
+                         uint16_t flags) {
+  bool ble = !is_154(parse_u64(row->f[C_MOD], 10));
+  uint32_t orig_len = size + (ble ? 14 : 5);
+  uint32_t incl_len = BS_MIN(orig_len, snaplen);
+  uint32_t pad = 0;
+  static const uint8_t zeroes[4] = {0};
+
+  if (format == OUT_PCAPNG) {
+    pad = (4 - incl_len % 4) % 4;
+    put_u32(6); /* EPB */
+    put_u32(32 + incl_len + pad);
+    put_u32(ble ? 0 : 1);
+    put_u32(ts >> 32);
+    put_u32((uint32_t)ts);
+  } else {
+    put_u32(ts / 1000000);
+    put_u32(ts % 1000000);
+  }
+  put_u32(incl_len);
+  put_u32(orig_len);
+
+  uint32_t address = parse_u64(row->f[C_ADDR], 16);
+  uint8_t channel = rf_channel(row);
+  if (ble) {
+    uint8_t phdr[14];
+    phdr[0] = channel;
+    phdr[1] = (int8_t)parse_d(row->f[C_POWER]); /* Signal power: Tx power */
+    phdr[2] = 0; /* Noise power */
+    phdr[3] = 0; /* Access address offenses */
+    memset(&phdr[4], 0, 4); /* Reference access address */
+    memcpy(&phdr[8], &flags, 2);
+    memcpy(&phdr[10], &address, 4);
+    fwrite(phdr, BS_MIN(incl_len, 14), 1, out);
+    if (incl_len > 14) {
+      fwrite(data, incl_len - 14, 1, out);
+    }
+  } else {
+    uint8_t hdr[5] = { 0, 0, 0, 0, (uint8_t)address }; /* Preamble + SFD */
+    fwrite(hdr, BS_MIN(incl_len, 5), 1, out);
+    if (incl_len > 5) {
+      fwrite(data, incl_len - 5, 1, out);
+    }
+  }
+
+  if (format == OUT_PCAPNG) {
+    fwrite(zeroes, pad, 1, out);
+    put_u32(32 + incl_len + pad);
+  }
+}
+
+static void write_bttrp(const row_t *row, const char *phy, field_t packet) {
+  double freq = parse_d(row->f[C_FREQ]);
+
+  while ((packet.len > 0) && ((packet.ptr[packet.len - 1] == ' ')
+                              || (packet.ptr[packet.len - 1] == '\r'))) {
+    packet.len--;
+  }
+  fprintf(out, "Item time=%"PRIu64" aa=%.*s rssi=-40 rfchannel=%i %s rawdata=\"%.*s\"\n",
+          row->time * 1000,
+          (int)row->f[C_ADDR].len, row->f[C_ADDR].ptr,
+          (int)((freq - 2) / 2), phy,
+          (int)packet.len, packet.ptr);
+}
+
+/**
+ * Convert a row (<next> being the following row from the same input, which
+ * for coded phy packets contains the FEC2 part)
+ * Returns true if <next> was consumed
+ */
+static bool convert(uint64_t basetime, const row_t *row, const row_t *next) {
+  uint mod = parse_u64(row->f[C_MOD], 10);
+  uint size = parse_u64(row->f[C_SIZE], 10);
+
+  if (size == 0) {
+    return false;
+  }
+
+  if (mod == MOD_BLE_CODED) {
+    /* FEC1 (the CI byte) followed by the FEC2 (the rest of the packet) */
+    if ((size != 1) || (next == NULL) || (parse_u64(next->f[C_MOD], 10) != MOD_BLE_CODED)
+        || (parse_u64(next->f[C_SIZE], 10) < 5)) {
+      return false;
+    }
+    if (format == OUT_BTTRP) {
+      char phy[32];
+      uint8_t ci = 0;
+      decode_packet(row->f[C_PACKET], &ci, 1);
+      snprintf(phy, sizeof(phy), "phy=Coded coding=Coded%i", ci == 0 ? 8 : 2);
+      write_bttrp(row, phy, next->f[C_PACKET]);
+    } else if (format != OUT_PCAP154) {
+      uint n = decode_packet(row->f[C_PACKET], packet_buf, 1);
+      n += decode_packet(next->f[C_PACKET], &packet_buf[n], 65536);
+      write_packet(basetime + row->time, row, packet_buf, n,
+                   PHDR_PHY_CODED | PHDR_SIGNAL_POWER);
+    }
+    return true;
+  }
+
+  if (is_154(mod)) {
+    if ((format == OUT_PCAP154) || (format == OUT_PCAPNG)) {
+      uint n = decode_packet(row->f[C_PACKET], packet_buf, 65536);
+      write_packet(basetime + row->time, row, packet_buf, n, 0);
+    }
+    return false;
+  }
+
+  if (format == OUT_BTTRP) {
+    if (mod == MOD_BLE) {
+      write_bttrp(row, "phy=1Mbps", row->f[C_PACKET]);
+    } else if ((mod == MOD_BLE2M) || (mod == MOD_BLE2M + 1)) { /* (as csv2bttrp) */
+      write_bttrp(row, "phy=2Mbps", row->f[C_PACKET]);
+    }
+  } else if (format != OUT_PCAP154) {
+    uint16_t flags = PHDR_SIGNAL_POWER;
+    if (mod == MOD_BLE2M) {
+      flags |= PHDR_PHY_2M;
+    }
+    uint n = decode_packet(row->f[C_PACKET], packet_buf, 65536);
+    if (n != size) {
+      bs_trace_warning_line("Truncated input file (partial packet), writing partial packet in output\n");
+    }
+    write_packet(basetime + row->time, row, packet_buf, n, flags);
+  }
+  return false;
+}
+
+int main(int argc, char *argv[]) {
+  const char *out_name = NULL;
+  const char *format_name = NULL;
+  bool epoch_real = false;
+
+  const char **in_names = bs_calloc(argc, sizeof(char *));
+
+  n_inputs = 0;
+
+  for (int i = 1; i < argc; i++) {
+    if ((strcmp(argv[i], "-f") == 0) && (i + 1 < argc)) {
+      format_name = argv[++i];
+    } else if ((strcmp(argv[i], "-o") == 0) && (i + 1 < argc)) {
+      out_name = argv[++i];
+    } else if ((strcmp(argv[i], "-s") == 0) && (i + 1 < argc)) {
+      snaplen = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-er") == 0) {
+      epoch_real = true;
+    } else if ((strcmp(argv[i], "-from") == 0) && (i + 1 < argc)) {
+      from = strtoull(argv[++i], NULL, 10);
+    } else if ((strcmp(argv[i], "-to") == 0) && (i + 1 < argc)) {
+      to = strtoull(argv[++i], NULL, 10);
+    } else if (argv[i][0] == '-') {
+      usage(argv[0]);
+    } else {
+      in_names[n_inputs++] = argv[i];
+    }
+  }
+  if ((format_name == NULL) || (n_inputs == 0)) {
+    usage(argv[0]);
+  }
+  inputs = bs_calloc(n_inputs, sizeof(input_t));
+  for (uint i = 0; i < n_inputs; i++) {
+    open_input(&inputs[i], in_names[i]);
+  }
+  if (strcmp(format_name, "pcap") == 0) {
+    format = OUT_PCAP;
+  } else if (strcmp(format_name, "pcapng") == 0) {
+    format = OUT_PCAPNG;
+  } else if (strcmp(format_name, "pcap154") == 0) {
+    format = OUT_PCAP154;
+  } else if (strcmp(format_name, "bttrp") == 0) {
+    format = OUT_BTTRP;
+  } else {
+    usage(argv[0]);
+  }
+
+  uint64_t basetime = 0;
+  if (epoch_real) {
+    /* The simulation start, approximated by the oldest input modification time */
+    time_t oldest = 0;
+    for (uint i = 0; i < n_inputs; i++) {
+      struct stat st;
+      if ((stat(inputs[i].name, &st) == 0) && ((oldest == 0) || (st.st_mtime < oldest))) {
+        oldest = st.st_mtime;
+      }
+    }
+    basetime = (uint64_t)oldest * 1000000;
+  }
+
+  out = stdout;
+  if (out_name != NULL) {
+    out = bs_fopen(out_name, "wb");
+  }
+  setvbuf(out, NULL, _IOFBF, OUT_BUF_SIZE);
+  packet_buf = bs_malloc(2*65536);
+
+  write_header();
+
+  heap = bs_calloc(n_inputs, sizeof(uint));
+  heap_len = 0;
+  for (uint i = 0; i < n_inputs; i++) {
+    if (next_row(&inputs[i])) {
+      heap[heap_len] = i;
+      heap_up(heap_len++);
+    }
+  }
+
+  while (heap_len > 0) {
+    uint i = heap[0];
+    input_t *in = &inputs[i];
+    row_t row = in->row;
+    bool more;
+
+    if ((row.time > to) && !in->mux) {
+      /* Per device inputs are in time order, all that follows is after <to> */
+      more = false;
+    } else {
+      more = next_row(in);
+      if ((row.time >= from) && (row.time <= to)
+          && convert(basetime, &row, more ? &in->row : NULL)) {
+        more = next_row(in);
+      }
+    }
+    if (more) {
+      heap_down(0);
+    } else {
+      heap[0] = heap[--heap_len];
+      heap_down(0);
+    }
+  }
+
+  for (uint i = 0; i < n_inputs; i++) {
+    if (inputs[i].map != NULL) {
+      munmap((void *)inputs[i].map, inputs[i].map_size);
+    }
+  }
+  free(inputs);
+  free(in_names);
+  free(heap);
+  free(packet_buf);
+  if (out != stdout) {
+    fclose(out);
+  } else {
+    fflush(out);
+  }
+  return 0;
+}
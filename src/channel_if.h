@@ -54,6 +54,22 @@ int channel_init(int argc, char *argv[], uint n_devs);
  */
 int channel_calc(const uint *tx_used, tx_el_t *tx_list, uint txnbr, uint rxnbr, bs_time_t now, double *att, double *ISI_SNR);
 
+/**
+ * (Optional) Report if the channel is time invariant
+ *
+ * A channel is time invariant if the results of channel_calc() only depend
+ * on which devices are transmitting and their transmission parameters,
+ * but not on the time (<now>) of the call.
+ * The Phy may use this information to avoid recalculating the channel when
+ * nothing else has changed.
+ *
+ * Channels which do not implement this function are assumed to be time variant
+ *
+ * This function shall return != 0 if the channel is time invariant, 0 otherwise
+ * It is called once, after channel_init()
+ */
+int channel_time_invariant();
+
 /**
  * Clean up: Free the memory the channel may have allocate
  * close any file descriptors etc.
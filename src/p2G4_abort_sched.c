@@ -0,0 +1,84 @@
+/*
+ * Copyright 2026 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <stdlib.h>
+#include <string.h>
+#include "bs_types.h"
+#include "bs_oswrap.h"
+#include "bs_tracing.h"
+#include "p2G4_abort_sched.h"
+
+typedef struct {
+  p2G4_abort_t entries[P2G4_ABORT_SCHED_MAX];
+  uint n_entries; //Number of valid entries
+  uint next; //Next entry to be applied
+  uint32_t flags;
+  p2G4_rssi_power_t rssi_threshold;
+  unsigned long long reevals; //Number of abort reevaluations
+  unsigned long long internal; //of which resolved without contacting the device
+} abort_sched_t;
+
+static abort_sched_t *sched = NULL;
+static uint n_devs = 0;
+
+void asch_init(uint n_devs_i) {
+  n_devs = n_devs_i;
+  sched = bs_calloc(n_devs, sizeof(abort_sched_t));
+}
+
+void asch_free(void) {
+  if (sched == NULL) {
+    return;
+  }
+  for (uint d = 0; d < n_devs; d++) {
+    if (sched[d].reevals > 0) {
+      bs_trace_raw(3, "Device %u: %llu abort reevaluations, %llu resolved by the Phy (%.1f%%)\n",
+                   d, sched[d].reevals, sched[d].internal,
+                   sched[d].internal*100.0/sched[d].reevals);
+    }
+  }
+  free(sched);
+  sched = NULL;
+}
+
+void asch_set(uint d, p2G4_abort_sched_t *s, p2G4_abort_t *entries, bool rssi_allowed) {
+  uint n = s->n_entries - 1;
+
+  memcpy(sched[d].entries, entries, n*sizeof(p2G4_abort_t));
+  sched[d].n_entries = n;
+  sched[d].next = 0;
+  sched[d].flags = s->flags;
+  if (!rssi_allowed && (s->flags & P2G4_ABORT_SCHED_RSSI_COND)) {
+    bs_trace_warning_line("Device %u sent an abort schedule with an RSSI condition during a Tx, "
+                          "ignoring the condition\n", d);
+    sched[d].flags &= ~P2G4_ABORT_SCHED_RSSI_COND;
+  }
+  sched[d].rssi_threshold = s->rssi_threshold;
+}
+
+void asch_clear(uint d) {
+  if (sched != NULL) {
+    sched[d].n_entries = 0;
+    sched[d].next = 0;
+  }
+}
+
+bool asch_pending(uint d) {
+  return sched[d].next < sched[d].n_entries;
+}
+
+bool asch_rssi_cond(uint d, p2G4_rssi_power_t *threshold) {
+  *threshold = sched[d].rssi_threshold;
+  return (sched[d].flags & P2G4_ABORT_SCHED_RSSI_COND) != 0;
+}
+
+void asch_pop(uint d, p2G4_abort_t *ab) {
+  *ab = sched[d].entries[sched[d].next++];
+}
+
+void asch_count_reeval(uint d, bool internal) {
+  sched[d].reevals++;
+  sched[d].internal += internal;
+}
@@ -0,0 +1,102 @@
+/*
+ * Copyright 2026 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#ifndef P2G4_ABORT_SCHED_H
+#define P2G4_ABORT_SCHED_H
+
+#include "bs_types.h"
+#include "bs_pc_2G4_types.h"
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/**
+ * Abort schedules
+ *
+ * Normally, on each abort recheck of an ongoing Tx, Rx or CCA, the Phy sends
+ * P2G4_MSG_ABORTREEVAL to the device and waits for its new abort structure.
+ * Instead of P2G4_MSG_RERESP_ABORTREEVAL + p2G4_abort_t, the device may
+ * respond with P2G4_MSG_RERESP_ABORT_SCHED followed by a p2G4_abort_sched_t
+ * and n_entries p2G4_abort_t.
+ *
+ * The first entry is applied immediately (exactly as if it had been sent
+ * with P2G4_MSG_RERESP_ABORTREEVAL). The following ones are applied, in order,
+ * in the next rechecks of that same operation, without contacting the device.
+ * When the schedule is exhausted, the Phy goes back to asking the device.
+ * A schedule is dropped when the operation ends, and when the device
+ * provides a new abort by other means (e.g. in P2G4_MSG_RXV2CONT).
+ *
+ * If P2G4_ABORT_SCHED_RSSI_COND is set, in each of those internal rechecks
+ * the Phy measures the RSSI (with the operation radio parameters and antenna
+ * gain) and, if it is at or over rssi_threshold, aborts immediately instead
+ * of applying the next entry.
+ * This condition is only valid for Rx and CCA operations. A device can not
+ * measure the RSSI while it is transmitting, so during a Tx the condition is
+ * ignored (with a warning) and the schedule entries applied as they are.
+ */
+
+#define P2G4_MSG_RERESP_ABORT_SCHED 0x7002
+
+#define P2G4_ABORT_SCHED_MAX 32
+
+#define P2G4_ABORT_SCHED_RSSI_COND 0x1
+
+typedef struct {
+  uint32_t n_entries; /* Number of p2G4_abort_t which follow (1..P2G4_ABORT_SCHED_MAX) */
+  uint32_t flags; /* P2G4_ABORT_SCHED_* */
+  p2G4_rssi_power_t rssi_threshold; /* Only used with P2G4_ABORT_SCHED_RSSI_COND */
+} p2G4_abort_sched_t;
+
+/**
+ * Allocate the abort schedules for <n_devs> devices
+ */
+void asch_init(uint n_devs);
+
+/**
+ * Print the abort reevaluation statistics and free the schedules
+ */
+void asch_free(void);
+
+/**
+ * Store a new schedule for device <d>, replacing any previous one
+ * (<entries> are the n_entries - 1 entries after the one already applied)
+ * <rssi_allowed> tells if the ongoing operation can have an RSSI condition
+ * (not a Tx); if it can not, any RSSI condition is dropped with a warning
+ */
+void asch_set(uint d, p2G4_abort_sched_t *sched, p2G4_abort_t *entries, bool rssi_allowed);
+
+/**
+ * Drop any pending schedule for device <d>
+ */
+void asch_clear(uint d);
+
+/**
+ * Does device <d> have pending schedule entries
+ */
+bool asch_pending(uint d);
+
+/**
+ * Does the pending schedule of device <d> have an RSSI condition
+ * and if so which threshold
+ */
+bool asch_rssi_cond(uint d, p2G4_rssi_power_t *threshold);
+
+/**
+ * Take the next entry of the device <d> schedule
+ */
+void asch_pop(uint d, p2G4_abort_t *ab);
+
+/**
+ * Account for an abort reevaluation of device <d>
+ * (<internal> = resolved by the Phy without contacting the device)
+ */
+void asch_count_reeval(uint d, bool internal);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,24 @@
+/*
+ * Copyright 2026 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#define _GNU_SOURCE
+#include <string.h>
+#include <errno.h>
+#include <sched.h>
+#include "bs_tracing.h"
+#include "p2G4_affinity.h"
+
+void p2G4_set_cpu_affinity(int cpu) {
+  cpu_set_t set;
+
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+  if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+    bs_trace_warning_line("Could not pin the Phy to CPU %i (%s)\n", cpu, strerror(errno));
+  } else {
+    bs_trace_raw(5, "Phy pinned to CPU %i\n", cpu);
+  }
+}
@@ -0,0 +1,22 @@
+/*
+ * Copyright 2026 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#ifndef P2G4_AFFINITY_H
+#define P2G4_AFFINITY_H
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/**
+ * Pin the Phy process to the given CPU
+ */
+void p2G4_set_cpu_affinity(int cpu);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
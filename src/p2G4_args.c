@@ -31,10 +31,24 @@ static inline void allocate_modems_params(p2G4_args_t *args){
   args->modem_name = (char **)bs_calloc(args->n_devs, sizeof(char*));
   args->modem_argc = (uint *)bs_calloc(args->n_devs, sizeof(uint));
   args->modem_argv = (char ***)bs_calloc(args->n_devs, sizeof(char**));
+  args->synth_spec = (char **)bs_calloc(args->n_devs, sizeof(char*));
 }
 
 p2G4_args_t *args_g;
 
+static void check_synth_nbr(p2G4_args_t *args, uint synth_nbr, char *argv) {
+  if ( args->n_devs == 0 ) {
+    bs_trace_error_line("cmdarg: tried to set a synthetic device (%i) before "
+                        "setting the number of devices (-D=<nbr>) (%s)\n",
+                        synth_nbr, argv);
+  }
+  if ( synth_nbr >= args->n_devs ) {
+    bs_trace_error_line("cmdarg: tried to set a synthetic device %i >= %i "
+                        "number of avaliable devices (%s)\n",
+                        synth_nbr, args->n_devs, argv);
+  }
+}
+
 static void cmd_trace_lvl_found(char * argv, int offset){
   bs_trace_set_level(args_g->verb);
 }
@@ -44,8 +58,34 @@ static void phy_id_found(char * argv, int offset){
 double sim_length;
 static void sim_length_found(char * argv, int offset){
   args_g->sim_length = sim_length;
+  args_g->sim_length_set = true;
   bs_trace_raw(9,"cmdarg: sim_length set to %"PRItime"\n", args_g->sim_length);
 }
+double rssi_coherence;
+static void rssi_coherence_found(char * argv, int offset){
+  args_g->rssi_coherence = rssi_coherence;
+  bs_trace_raw(9,"cmdarg: rssi_coherence set to %"PRItime"\n", args_g->rssi_coherence);
+}
+double digest_cp;
+static void digest_cp_found(char * argv, int offset){
+  args_g->digest_cp = digest_cp;
+  bs_trace_raw(9,"cmdarg: digest_cp set to %"PRItime"\n", args_g->digest_cp);
+}
+double dump_from;
+static void dump_from_found(char * argv, int offset){
+  args_g->dump_from = dump_from;
+  bs_trace_raw(9,"cmdarg: dump_from set to %"PRItime"\n", args_g->dump_from);
+}
+double dump_to;
+static void dump_to_found(char * argv, int offset){
+  args_g->dump_to = dump_to;
+  bs_trace_raw(9,"cmdarg: dump_to set to %"PRItime"\n", args_g->dump_to);
+}
+double dump_idx;
+static void dump_idx_found(char * argv, int offset){
+  args_g->dump_idx = dump_idx;
+  bs_trace_raw(9,"cmdarg: dump_idx set to %"PRItime"\n", args_g->dump_idx);
+}
 static void stop_found(char * argv, int offset){
   args_g->compare = true;
 }
@@ -80,13 +120,40 @@ void p2G4_argsparse(int argc, char *argv[], p2G4_args_t *args)
       ARG_TABLE_FORCECOLOR,
       { false, false  , true,  "nodump",    "no_dump",  'b', (void*)&args->dont_dump,      NULL,         "Will not dump (or compare) any files"},
       { false, false  , true,  "dump_imm",  "dump_imm", 'b', (void*)&args->dump_imm,       NULL,         "When dumping, do not buffer more than a line"},
+      { false, false  , true,  "dump_bin",  "dump_bin", 'b', (void*)&args->dump_bin,       NULL,         "Dump in the binary format (d_<p_id>_<dev>.<stream>.bin files, see docs/README_dumps.md) instead of CSV"},
+      { false, false  , true,  "dump_mux",  "dump_mux", 'b', (void*)&args->dump_mux,       NULL,         "Dump all devices into a single file per type (d_<p_id>.<type>.csv/bin, with a device column), created only when the first record of that type is dumped"},
+      { false, false  , true,  "dump_compress","dump_compress",'b', (void*)&args->dump_compress, NULL,     "Compress the dump files with gzip (<file>.gz) as they are written (only if the Phy was built with zlib)"},
+      { false, false  , true,  "pcapng",    "pcapng",   'b', (void*)&args->pcapng,         NULL,         "Capture all transmitted and received packets into results/<s_id>/d_<p_id>.pcapng as the simulation runs (independently of the dumps)"},
+      { false, false  , false, "pcapng_live","path",    's', (void*)&args->pcapng_live,   NULL,         "Feed the pcapng capture live thru this FIFO (if it exists) or Unix socket (which the Phy will listen on), for ex. to follow the simulation in Wireshark. Slow readers miss packets instead of stalling the Phy"},
+      { false, false  , true,  "modemrx_sparse","modemrx_sparse",'b', (void*)&args->modemrx_sparse, NULL, "Dump the ModemRx information in the sparse format (d_<p_id>_<dev>.ModemRxSparse.csv, only the active transmitters) instead of with a column pair per device"},
+      { false, false  , false, "dump_devs", "list",     's', (void*)&args->dump_devs,     NULL,         "Only dump these devices (comma separated list of devices or ranges, for ex. 0,3-5). By default all"},
+      { false, false  , false, "dump_streams","list",   's', (void*)&args->dump_streams,  NULL,         "Only dump these record types (comma separated list of Tx, Rx, RSSI, CCA, ModemRx). By default all"},
+      { false, false  , false, "dump_from", "time",     'f', (void*)&dump_from,           dump_from_found, "In us, only dump records which start at or after this time. By default 0"},
+      { false, false  , false, "dump_to",   "time",     'f', (void*)&dump_to,             dump_to_found, "In us, only dump records which start at or before this time. By default till the end"},
+      { false, false  , false, "dump_freqs","list",     's', (void*)&args->dump_freqs,    NULL,         "Only dump records in these center frequencies (comma separated list, in MHz above 2400 as in the dumps, for ex. 2,26,80). By default all"},
+      { false, false  , false, "dump_addrs","list",     's', (void*)&args->dump_addrs,    NULL,         "Only dump the Tx and Rx with these phy addresses (comma separated list, for ex. 0x8E89BED6). By default all"},
+      { false, false  , false, "dump_idx",  "time",     'f', (void*)&dump_idx,            dump_idx_found, "In us, write next to each dump file a time index (<file>.idx) with an entry every this much time, to seek into the dumps by time (for ex. 10000). By default 0 (no indexes)"},
+      { false, false  , true,  "dump_digest","dump_digest",'b', (void*)&args->dump_digest,  NULL,         "Do not dump any file, only keep a digest per device and stream of what would have been dumped, and write them into d_<p_id>.digest (or compare them with it in compare mode)"},
+      { false, false  , false, "digest_cp", "time",     'f', (void*)&digest_cp,           digest_cp_found, "In us, with -dump_digest, how often to checkpoint the digests (to find when 2 runs diverged). By default 1s (0 = never)"},
       { false, false  , true,  "dump",      "dump",     'b', (void*)NULL,                 dump_found,    "Revert -nodump option (note that the last -nodump/dump set in the command line prevails)"},
       { false, false  , true,  "crcerr_data","crcerr",  'b', (void*)&args->crcerr_data,    NULL,         "Provide uncorrupted packet to device attempting to receive even if packet has a CRC error or reception is aborted midway (disabled by default)"},
       { false, false  , true,  "c",          "compare", 'b', (void*)&args->compare,        NULL,         "Run in compare mode: will compare instead of dumping"},
       { false, false  , true,  "stop_on_diff","stop",   'b', (void*)&args->stop_on_diff,  stop_found,    "Run in compare mode, but stop as soon as a difference is found"},
+      { false, false  , true,  "rssi_cache", "rssi_cache", 'b', (void*)&args->rssi_cache,   NULL,         "Reuse a device previous RSSI measurement result if nothing changed in the air (and the channel is time invariant or the coherence time has not passed) (disabled by default)"},
+      { false, false  , false, "rssi_coherence","time", 'f', (void*)&rssi_coherence, rssi_coherence_found, "In us, for how long a cached RSSI measurement is valid with time varying channels (-rssi_cache). By default 0"},
+      { false, false  , true,  "cca_skip",   "cca_skip", 'b', (void*)&args->cca_skip,     NULL,         "During CCA measurements, do not reschedule measurements while nothing changes in the air, but account for them all at once. Only with time invariant channels (disabled by default)"},
+      { false, false  , true,  "fast_crc",   "fast_crc", 'b', (void*)&args->fast_crc,     NULL,         "Fast statistics mode for the packet payload: sample directly when the first bit error happens instead of calculating errors every us. Statistically equivalent, but the dumped number of bit errors will not include all payload errors (disabled by default)"},
+      { false, false  , true,  "fast_rand",  "fast_rand",'b', (void*)&args->fast_rand,    NULL,         "Use the Phy own block random number generators for bit errors and sync calculations, instead of libRandv2 (faster, but results will differ from runs without this option) (disabled by default)"},
+      { false, false  , true,  "no_shm",     "no_shm",  'b', (void*)&args->no_shm,       NULL,         "Refuse device requests to switch to the shared memory transport, and keep using the FIFOs for all devices"},
+      { false, false  , false, "spin",       "iterations",'u', (void*)&args->shm_spin,    NULL,         "With the shared memory transport, poll for the device for this many iterations before blocking (for Phy and devices pinned to dedicated cores). By default 0 (always block)"},
+      { false, false  , false, "cpu",        "cpu",     'i', (void*)&args->cpu,           NULL,         "Pin the Phy to this CPU. By default not pinned"},
+      { false, false  , false, "rec_req",    "file",    's', (void*)&args->rec_req_file,  NULL,         "Record everything the devices send to the Phy into this file (to be replayed later with -replay)"},
+      { false, false  , false, "replay",     "file",    's', (void*)&args->replay_file,   NULL,         "Do not connect to any device, instead replay what they sent from a file recorded with -rec_req (the Phy must be run with the same parameters)"},
       { false, false  , false, "channel",    "channel", 's', (void*)&args->channel_name,  channel_found, "Which channel will be used ( lib/lib_2G4Channel_<channel>.so ). By default NtNcable"},
       { false, false  , false, "defmodem",   "modem",   's', (void*)&args->defmodem_name, defmodem_found,"Which modem will be used by default for all devices ( lib/lib_2G4Modem_<modem>.so ). By default Magic"},
       { true,  false  , false, "modem<nbr>", "modem",   's', (void*)NULL,                  NULL,         "Which modem will be used for the device <nbr> ( lib/lib_2G4Modem_<modem>.so )"},
+      { true,  false  , false, "synth<nbr>", "type[,period]",'s', (void*)NULL,        NULL,         "Make device <nbr> an in-process synthetic device instead of a real one. <type> is one of adv (BLE advertiser), conn (BLE connection central) or csma (802.15.4 CSMA-CA sender). <period> in us. Synthetic devices must be the last devices"},
+      { true,  false  , false, "synthfrom<nbr>","type[,period]",'s', (void*)NULL,     NULL,         "As -synth<nbr>, but for all devices from <nbr> on"},
       { true,  false  , false, "argschannel","arg",     'l', (void*)NULL,                  NULL,         "Following arguments (until end or new -args*) will be passed to the channel"},
       { true,  false  , false, "argsdefmodem","arg",    'l', (void*)NULL,                  NULL,         "Following arguments (until end or new -args*) will be passed to the modems set to be the default modem"},
       { true,  false  , false, "argsmodem<nbr>","arg",  'l', (void*)NULL,                  NULL,         "Following arguments (until end or new -args*) will be passed to the modem of the device <nbr>"},
@@ -106,6 +173,10 @@ void p2G4_argsparse(int argc, char *argv[], p2G4_args_t *args)
   bs_trace_set_level(args->verb);
   args->rseed      = 0xFFFF;
   args->sim_length = TIME_NEVER - 1000000000 ; //1Ksecond before never by default
+  args->digest_cp  = 1000000;
+  args->dump_from  = 0;
+  args->dump_to    = TIME_NEVER;
+  args->cpu        = -1;
 
   args->channel_argv    = bs_calloc(MAXPARAMS_LIBRARIES*2, sizeof(char *));
   args->channel_argc    = 0;
@@ -118,12 +189,14 @@ void p2G4_argsparse(int argc, char *argv[], p2G4_args_t *args)
   args->modem_argv = NULL;
   args->modem_argc = NULL;
   args->modem_name = NULL;
+  args->synth_spec = NULL;
 
   char trace_prefix[] = "cmdarg: ";
   bs_args_set_trace_prefix(trace_prefix);
 
   int offset;
   uint modem_nbr;
+  uint synth_nbr;
 
   for (int i=1; i<argc; i++){ 
 
@@ -187,6 +260,18 @@ void p2G4_argsparse(int argc, char *argv[], p2G4_args_t *args)
           args->modem_name[modem_nbr] = &argv[i][offset];
           bs_trace_raw(9, "cmdarg: modem[%u] set to libModem_%s.so\n",
                        modem_nbr, args->modem_name[modem_nbr]);
+        } else if ((offset = bs_is_multi_opt(argv[i], "synthfrom", &synth_nbr, 1))>0) {
+          check_synth_nbr(args, synth_nbr, argv[i]);
+          for (uint d = synth_nbr; d < args->n_devs; d++) {
+            args->synth_spec[d] = &argv[i][offset];
+          }
+          bs_trace_raw(9, "cmdarg: devices %u.. set to synthetic %s\n",
+                       synth_nbr, &argv[i][offset]);
+        } else if ((offset = bs_is_multi_opt(argv[i], "synth", &synth_nbr, 1))>0) {
+          check_synth_nbr(args, synth_nbr, argv[i]);
+          args->synth_spec[synth_nbr] = &argv[i][offset];
+          bs_trace_raw(9, "cmdarg: device %u set to synthetic %s\n",
+                       synth_nbr, args->synth_spec[synth_nbr]);
         }
         else {
           bs_args_print_switches_help(args_struct);
@@ -270,4 +355,8 @@ void p2G4_clear_args_struct(p2G4_args_t *args){
   if (args->modem_argv != NULL) {
       free(args->modem_argv);
   }
+
+  if (args->synth_spec != NULL) {
+      free(args->synth_spec);
+  }
 }
@@ -18,11 +18,37 @@ typedef struct{
   ARG_S_ID
   ARG_P_ID
   bs_time_t sim_length;
+  bool sim_length_set; /* -sim_length was given */
   bool dont_dump;
   bool dump_imm;
+  bool dump_bin;
+  bool dump_mux;
+  bool dump_compress;
+  bool pcapng;
+  char *pcapng_live;
+  bool modemrx_sparse;
+  char *dump_devs;
+  char *dump_streams;
+  bs_time_t dump_from;
+  bs_time_t dump_to;
+  char *dump_freqs;
+  char *dump_addrs;
+  bs_time_t dump_idx;
+  bool dump_digest;
+  bs_time_t digest_cp;
   bool crcerr_data;
   bool compare;
   bool stop_on_diff;
+  bool rssi_cache;
+  bs_time_t rssi_coherence;
+  bool cca_skip;
+  bool fast_crc;
+  bool fast_rand;
+  bool no_shm;
+  uint shm_spin;
+  int cpu;
+  char *rec_req_file;
+  char *replay_file;
   ARG_VERB
   ARG_SEED
 
@@ -36,6 +62,8 @@ typedef struct{
   char **modem_name;
   char ***modem_argv;
   uint *modem_argc;
+
+  char **synth_spec;
 } p2G4_args_t;
 
 void p2G4_argsparse(int argc, char *argv[], p2G4_args_t *args);
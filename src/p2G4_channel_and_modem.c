@@ -15,8 +15,15 @@
  *
  *  chm_is_packet_synched(): Is the modem able to synchronize a packet or not
  *  chm_bit_errors(): how many bit errors there is while receiving a given micros of a packet
+ *  chm_BER(): the bit error probability while receiving a given micros of a packet
  *  chm_RSSImeas(): Return a RSSI measurement for a given modem
  *
+ * Optionally, RSSI measurements can be cached per receiver, so consecutive
+ * measurements with the same air state (same Tx list and same receiver
+ * configuration) do not need to call again into the channel and modem.
+ * The cached value is reused forever if the channel reports itself as time
+ * invariant, or otherwise for up to a configurable coherence time.
+ *
  * It interfaces with a channel (library) and a set of modems (libraries)
  * One channel will be loaded for all links (the channel shall keep the status of NxN links)
  * N modems will be loaded (one for each receiver). Each modem may be of the same type or different type
@@ -39,6 +46,7 @@
 #include "p2G4_channel_and_modem_priv.h"
 #include "p2G4_dump.h"
 #include "p2G4_pending_tx_rx_list.h"
+#include "p2G4_rand.h"
 
 static uint n_devs;
 
@@ -48,10 +56,12 @@ static void **modem_lib  = NULL;
 typedef int  (*cha_init_f)(int argc, char *argv[], uint n_devs);
 typedef int  (*cha_calc_f)(const uint *tx_used, tx_el_t *tx_list, uint txnbr, uint rxnbr, bs_time_t now, double *att, double *ISI_SNR);
 typedef void (*cha_delete_f)();
+typedef int  (*cha_time_inv_f)();
 
 static cha_init_f   channel_init;
 static cha_calc_f   channel_calc;
 static cha_delete_f channel_delete;
+static cha_time_inv_f channel_time_inv;
 
 typedef void*  (*m_init_f)(int argc, char *argv[], uint dev_nbr, uint n_devs);
 typedef void   (*m_delete_f)(void *m_obj);
@@ -72,7 +82,12 @@ static void** modem_o = NULL; //Array of modem objects: one for each device/rece
 // status of each receiver (its receiver chain and the channel fading towards it from all paths)
 static rec_status_t *rec_status;
 
-void channel_and_modem_init(uint ch_argc, char** ch_argv, const char* ch_name, uint *mo_argc, char*** mo_argv, char** mo_name, uint n_devs_i){
+static bool RSSI_cache_enabled = false;
+static bool channel_is_time_invariant = false;
+static bs_time_t RSSI_coherence_time = 0;
+
+void channel_and_modem_init(uint ch_argc, char** ch_argv, const char* ch_name, uint *mo_argc, char*** mo_argv, char** mo_name, uint n_devs_i,
+                            bool RSSI_cache, bs_time_t RSSI_coherence){
 
    char *error;
    uint d;
@@ -113,8 +128,22 @@ void channel_and_modem_init(uint ch_argc, char** ch_argv, const char* ch_name, u
      bs_trace_error_line("%s\n",error);
    }
 
+   //channel_time_invariant() is optional
+   *(void **) (&channel_time_inv) = dlsym(channel_lib, "channel_time_invariant");
+   dlerror();
+
    channel_init(ch_argc, ch_argv, n_devs);
 
+   RSSI_cache_enabled = RSSI_cache;
+   RSSI_coherence_time = RSSI_coherence;
+   if ( channel_time_inv != NULL ) {
+     channel_is_time_invariant = channel_time_inv();
+   }
+   if ( RSSI_cache_enabled ) {
+     bs_trace_raw(9, "chm: RSSI measurement cache enabled (channel %s time invariant, coherence time %"PRItime" us)\n",
+                  channel_is_time_invariant ? "is" : "is not", RSSI_coherence_time);
+   }
+
    //MODEM:
    modem_lib = bs_calloc(n_devs, sizeof(void*));
    m_init = (m_init_f*) bs_calloc(n_devs, sizeof(m_init_f));
@@ -244,11 +273,10 @@ static inline void combine_SNR(rec_status_t *rx_status ) {
 }
 
 /**
- * Return the number of biterrors while receiving this microsecond of the packet sent by device <tx_nbr>
- * and received by device <rx_nbr>.
- * Where <n_calcs> error samples are taken, each with the same parameters
+ * Return the bit error probability ([0.. RAND_PROB_1]) in this microsecond,
+ * for the packet sent by device <tx_nbr> and received by device <rx_nbr>
  */
-uint chm_bit_errors(tx_l_c_t *tx_l, uint tx_nbr, uint rx_nbr, rx_status_t *rx_st , bs_time_t current_time, uint n_calcs){
+uint32_t chm_BER(tx_l_c_t *tx_l, uint tx_nbr, uint rx_nbr, rx_status_t *rx_st , bs_time_t current_time){
 
   rec_status_t *status = &rec_status[rx_nbr];
 
@@ -269,7 +297,17 @@ uint chm_bit_errors(tx_l_c_t *tx_l, uint tx_nbr, uint rx_nbr, rx_status_t *rx_st
     dump_ModemRx(current_time, tx_nbr, rx_nbr, n_devs, 1, &rx_st->rx_modem_params, status, tx_l );
   } //otherwise all we had calculated before still applies
 
-  return bs_random_Binomial(n_calcs, status->BER);
+  return status->BER;
+}
+
+/**
+ * Return the number of biterrors while receiving this microsecond of the packet sent by device <tx_nbr>
+ * and received by device <rx_nbr>.
+ * Where <n_calcs> error samples are taken, each with the same parameters
+ */
+uint chm_bit_errors(tx_l_c_t *tx_l, uint tx_nbr, uint rx_nbr, rx_status_t *rx_st , bs_time_t current_time, uint n_calcs){
+
+  return p2G4_rand_Binomial(rx_nbr, n_calcs, chm_BER(tx_l, tx_nbr, rx_nbr, rx_st, current_time));
 }
 
 /**
@@ -302,7 +340,33 @@ uint chm_is_packet_synched(tx_l_c_t *tx_l, uint tx_nbr, uint rx_nbr, rx_status_t
     dump_ModemRx(current_time, tx_nbr, rx_nbr, n_devs, 0, &rx_st->rx_modem_params, rec_s, tx_l );
   }
 
-  return bs_random_Bern(rec_s->sync_prob);
+  return p2G4_rand_Bern(rx_nbr, rec_s->sync_prob);
+}
+
+/**
+ * Can the last RSSI measurement of this receiver be reused for a new one
+ * with these parameters in this instant
+ */
+static inline bool RSSI_cache_hit(rssi_cache_t *cache, tx_l_c_t *tx_l, p2G4_power_t rx_antenna_gain,
+                                  p2G4_radioparams_t *rx_radio_params, bs_time_t current_time){
+  if ( !cache->valid
+      || ( cache->tx_ctr != tx_l->ctr )
+      || ( cache->antenna_gain != rx_antenna_gain )
+      || ( cache->radio_params.center_freq != rx_radio_params->center_freq )
+      || ( cache->radio_params.modulation != rx_radio_params->modulation ) ) {
+    return false;
+  }
+  if ( channel_is_time_invariant ) {
+    return true;
+  }
+  return ( current_time - cache->time <= RSSI_coherence_time );
+}
+
+/**
+ * Did the channel report being time invariant (see channel_time_invariant())
+ */
+bool chm_channel_time_invariant(void) {
+  return channel_is_time_invariant;
 }
 
 /**
@@ -310,8 +374,15 @@ uint chm_is_packet_synched(tx_l_c_t *tx_l, uint tx_nbr, uint rx_nbr, rx_status_t
  */
 void chm_RSSImeas(tx_l_c_t *tx_l, p2G4_power_t rx_antenna_gain, p2G4_radioparams_t *rx_radio_params , p2G4_rssi_done_t* RSSI_meas, uint rx_nbr, bs_time_t current_time){
   rec_status_t *rec_s = &rec_status[rx_nbr];
+  rssi_cache_t *cache = &rec_s->RSSI_cache;
   p2G4_rssi_power_t RSSI;
 
+  if ( RSSI_cache_enabled
+      && RSSI_cache_hit(cache, tx_l, rx_antenna_gain, rx_radio_params, current_time) ) {
+    RSSI_meas->RSSI = cache->RSSI;
+    return;
+  }
+
   CalculateRxPowerAndISI(tx_l, rec_s, rx_antenna_gain, UINT_MAX, rx_nbr, current_time);
 
   m_analog_rx[rx_nbr](modem_o[rx_nbr], rx_radio_params,
@@ -321,5 +392,14 @@ void chm_RSSImeas(tx_l_c_t *tx_l, p2G4_power_t rx_antenna_gain, p2G4_radioparams
   m_dig_RSSI[rx_nbr](modem_o[rx_nbr], rx_radio_params,
                      rec_s->RSSI_meas_power, &RSSI);
   RSSI_meas->RSSI = RSSI;
+
+  if ( RSSI_cache_enabled ) {
+    cache->valid = true;
+    cache->tx_ctr = tx_l->ctr;
+    cache->time = current_time;
+    cache->antenna_gain = rx_antenna_gain;
+    cache->radio_params = *rx_radio_params;
+    cache->RSSI = RSSI;
+  }
 }
 
@@ -14,11 +14,14 @@
 extern "C"{
 #endif
 
-void channel_and_modem_init(uint cha_argc, char** cha_argv, const char* cha_name, uint *mo_argc, char*** mo_argv, char** mo_name, uint n_devs);
+void channel_and_modem_init(uint cha_argc, char** cha_argv, const char* cha_name, uint *mo_argc, char*** mo_argv, char** mo_name, uint n_devs,
+                            bool RSSI_cache, bs_time_t RSSI_coherence);
 void channel_and_modem_delete();
 uint chm_bit_errors(tx_l_c_t *tx_l, uint tx_nbr, uint rx_nbr, rx_status_t *rx_st , bs_time_t current_time, uint n_calcs);
+uint32_t chm_BER(tx_l_c_t *tx_l, uint tx_nbr, uint rx_nbr, rx_status_t *rx_st , bs_time_t current_time);
 uint chm_is_packet_synched(tx_l_c_t *tx_l, uint tx_nbr, uint rx_nbr, rx_status_t *rx_st, bs_time_t current_time);
 void chm_RSSImeas(tx_l_c_t *tx_l, p2G4_power_t rx_antenna_gain, p2G4_radioparams_t *rx_radio_params , p2G4_rssi_done_t* RSSI_meas, uint rx_nbr, bs_time_t current_time);
+bool chm_channel_time_invariant(void);
 
 #ifdef __cplusplus
 }
@@ -14,6 +14,20 @@
 extern "C"{
 #endif
 
+/**
+ * Cached result of the last RSSI measurement of a receiver (see chm_RSSImeas())
+ * It can be reused as long as the Tx list and the receiver configuration
+ * are the same, and the channel did not have time to change
+ */
+typedef struct {
+  bool valid;
+  uint64_t tx_ctr; //Tx list counter when the measurement was done
+  bs_time_t time; //When was the measurement done
+  p2G4_power_t antenna_gain;
+  p2G4_radioparams_t radio_params;
+  p2G4_rssi_power_t RSSI;
+} rssi_cache_t;
+
 typedef struct {
   uint64_t last_tx_ctr; //If the Tx doesn't change we don't need to recalculate the channel
   uint64_t last_rx_ctr; //During the same Rx, if the Tx doesn't change we assume the channel doesnt change
@@ -32,6 +46,8 @@ typedef struct {
 
   uint32_t BER;
   uint32_t sync_prob;
+
+  rssi_cache_t RSSI_cache;
 } rec_status_t;
 
 #ifdef __cplusplus
@@ -7,33 +7,357 @@
 #include "bs_pc_2G4_types.h"
 #include "bs_pc_2G4.h"
 #include "bs_tracing.h"
+#include "bs_oswrap.h"
+#include "p2G4_com.h"
+#include "p2G4_com_shm.h"
+#include "p2G4_abort_sched.h"
+#include "p2G4_req_log.h"
+#include "p2G4_synth.h"
 #include <unistd.h>
+#include <string.h>
+#include "bs_utils.h"
 
 static pb_phy_state_t cb_med_state = {0};
 
+/*
+ * Per device shared memory transport (NULL while the device uses the FIFOs)
+ */
+static p2G4_shm_t **shm = NULL;
+static uint n_devs = 0;
+static bool shm_allowed = true;
+
+/*
+ * When replaying a request log there are no devices,
+ * and synthetic devices (the last ones) never use the FIFOs (we only open
+ * them for the <n_real> first devices).
+ * For those we just keep track of which are still connected
+ */
+static bool replaying = false;
+static bool *nofifo_connected = NULL;
+static uint n_real = 0;
+static uint n_real_connected = 0;
+
+/*
+ * Per device buffers, so each message is sent with one write(),
+ * and received with (normally) one read()
+ */
+#define COM_IN_BUF_SIZE 4096
+
+typedef struct {
+  uint8_t *out;     /* Staging buffer for the message being assembled */
+  size_t out_size;  /* Allocated size of out */
+  size_t out_len;   /* Bytes staged so far */
+  uint8_t *in;      /* Data already read from the device but not yet consumed */
+  size_t in_start;
+  size_t in_end;
+  uint8_t *q;       /* Queued requests (P2G4_MSG_REQ_QUEUE) not yet consumed */
+  size_t q_size;    /* Allocated size of q */
+  size_t q_start;
+  size_t q_end;
+  bool q_reading;   /* The request being read came from the queue */
+} com_dev_buf_t;
+
+static com_dev_buf_t *dev_buf = NULL;
+
+static struct {
+  unsigned long long msgs_out;
+  unsigned long long writes;
+  unsigned long long msgs_in;
+  unsigned long long reads;
+  unsigned long long queued_reqs;
+} com_stats;
+
 #pragma GCC diagnostic ignored "-Wunused-result"
 
-void p2G4_phy_initcom(const char* s, const char* p, uint n){
-  if (pb_phy_initcom(&cb_med_state, s, p, n)) {
+void p2G4_phy_initcom(const char* s, const char* p, uint n, bool allow_shm, uint spin){
+  n_real = synth_first_dev();
+  n_real_connected = n_real;
+  replaying = rlog_replaying();
+  nofifo_connected = bs_calloc(n, sizeof(bool));
+  for (uint d = 0; d < n; d++) {
+    nofifo_connected[d] = true;
+  }
+  if (!replaying && (n_real > 0) && pb_phy_initcom(&cb_med_state, s, p, n_real)) {
     bs_trace_error_line("Cannot establish communication with devices\n");
   }
+  n_devs = n;
+  shm_allowed = allow_shm;
+  p2G4_shm_set_spin(spin);
+  shm = bs_calloc(n, sizeof(p2G4_shm_t *));
+  dev_buf = bs_calloc(n, sizeof(com_dev_buf_t));
+  for (uint d = 0; d < n; d++) {
+    dev_buf[d].in = bs_malloc(COM_IN_BUF_SIZE);
+  }
+}
+
+static bool com_is_connected(uint d) {
+  if (synth_is_synth(d) || replaying) {
+    return nofifo_connected[d];
+  }
+  return pb_phy_is_connected_to_device(&cb_med_state, d);
+}
+
+static void com_disconnect_devices(void) {
+  if (!replaying && (n_real > 0)) {
+    pb_phy_disconnect_devices(&cb_med_state);
+  }
+}
+
+/**
+ * The device <d> is gone (or disconnected while using the shared memory transport)
+ * Release its resources
+ */
+static void com_free_one_device(uint d) {
+  if (synth_is_synth(d)) {
+    nofifo_connected[d] = false;
+    return;
+  }
+  if (com_is_connected(d) && (--n_real_connected == 0)) {
+    synth_stop_all(); //Only background traffic is left
+  }
+  if (replaying) {
+    nofifo_connected[d] = false;
+    return;
+  }
+  pb_phy_free_one_device(&cb_med_state, d);
+  if (shm[d] != NULL) {
+    p2G4_shm_delete(shm[d]);
+    shm[d] = NULL;
+  }
+}
+
+static void com_shm_broken(uint d) {
+  bs_trace_warning_line("Low level communication with device %u broken (most likely the device was terminated)\n", d);
+  com_free_one_device(d);
+}
+
+static void com_stage(uint d, const void *buf, size_t size) {
+  com_dev_buf_t *b = &dev_buf[d];
+
+  if (b->out_len + size > b->out_size) {
+    b->out_size = b->out_len + size;
+    b->out = bs_realloc(b->out, b->out_size);
+  }
+  memcpy(&b->out[b->out_len], buf, size);
+  b->out_len += size;
+}
+
+/**
+ * Send everything staged for the device in one go
+ * thru whichever transport the device is using
+ */
+static void com_flush(uint d) {
+  com_dev_buf_t *b = &dev_buf[d];
+  size_t done = 0;
+
+  com_stats.msgs_out++;
+
+  if (synth_is_synth(d)) {
+    synth_receive(d, b->out, b->out_len);
+    b->out_len = 0;
+    return;
+  }
+
+  if (replaying) { //Nobody to send it to
+    b->out_len = 0;
+    return;
+  }
+
+  if (shm[d] != NULL) {
+    if (p2G4_shm_write(shm[d], b->out, b->out_len) != 0) {
+      com_shm_broken(d);
+    }
+    b->out_len = 0;
+    return;
+  }
+
+  while (done < b->out_len) {
+    ssize_t n = write(cb_med_state.ff_ptd[d], &b->out[done], b->out_len - done);
+    com_stats.writes++;
+    if (n <= 0) {
+      break;
+    }
+    done += n;
+  }
+  b->out_len = 0;
+}
+
+/**
+ * Send a message header, its structure (if any), and a payload (if any)
+ * to the device as one message
+ */
+static void com_send_msg(uint d, pc_header_t header, const void *s, size_t s_size,
+                         const void *payload, size_t p_size) {
+  com_stage(d, &header, sizeof(header));
+  if (s_size > 0) {
+    com_stage(d, s, s_size);
+  }
+  if (p_size > 0) {
+    com_stage(d, payload, p_size);
+  }
+  com_flush(d);
+}
+
+static void com_send_header(uint d, pc_header_t header) {
+  com_send_msg(d, header, NULL, 0, NULL, 0);
+}
+
+static ssize_t com_read_transport(uint d, void *buf, size_t size);
+
+/**
+ * Read <size> bytes from the device (or from the request log when replaying)
+ * Returns the number of bytes read
+ *
+ * Synthetic devices are neither recorded nor replayed: they just
+ * generate the same requests again
+ */
+static ssize_t com_read(uint d, void *buf, size_t size) {
+  ssize_t got;
+
+  if (synth_is_synth(d)) {
+    return synth_read(d, buf, size);
+  }
+  if (replaying) {
+    return rlog_replay(d, buf, size);
+  }
+  got = com_read_transport(d, buf, size);
+  rlog_record(d, buf, got);
+  return got;
+}
+
+/**
+ * Read <size> bytes from the device thru its transport
+ * Returns the number of bytes read
+ *
+ * With the FIFOs, we read as much as is available each time, so the
+ * remainder of a message (e.g. a Tx packet after its structure)
+ * is normally already in the buffer when it is needed
+ */
+static ssize_t com_read_transport(uint d, void *buf, size_t size) {
+  com_dev_buf_t *b = &dev_buf[d];
+  uint8_t *dst = buf;
+  size_t got = 0;
+
+  if (shm[d] != NULL) {
+    if (p2G4_shm_read(shm[d], buf, size) != 0) {
+      return 0;
+    }
+    return size;
+  }
+
+  while (got < size) {
+    if (b->in_start == b->in_end) {
+      ssize_t n;
+      b->in_start = 0;
+      b->in_end = 0;
+      if (size - got >= COM_IN_BUF_SIZE) { /* No point in copying it twice */
+        n = read(cb_med_state.ff_dtp[d], &dst[got], size - got);
+        com_stats.reads++;
+        if (n <= 0) {
+          break;
+        }
+        got += n;
+        continue;
+      }
+      n = read(cb_med_state.ff_dtp[d], b->in, COM_IN_BUF_SIZE);
+      com_stats.reads++;
+      if (n <= 0) {
+        break;
+      }
+      b->in_end = n;
+    }
+    size_t n = BS_MIN(size - got, b->in_end - b->in_start);
+    memcpy(&dst[got], &b->in[b->in_start], n);
+    b->in_start += n;
+    got += n;
+  }
+  return got;
 }
 
 void p2G4_phy_disconnect_all_devices(){
-  pb_phy_disconnect_devices(&cb_med_state);
+  if (shm != NULL) {
+    for (uint d = 0; d < n_devs; d++) {
+      if ((shm[d] != NULL) && com_is_connected(d)) {
+        pc_header_t header = PB_MSG_DISCONNECT;
+        p2G4_shm_write(shm[d], &header, sizeof(header));
+        //Release its FIFOs now, so it is not sent the disconnect again thru them
+        pb_phy_free_one_device(&cb_med_state, d);
+      }
+    }
+  }
+
+  com_disconnect_devices();
+  rlog_close();
+  synth_free();
+
+  if (shm != NULL) {
+    for (uint d = 0; d < n_devs; d++) {
+      p2G4_shm_delete(shm[d]);
+    }
+    free(shm);
+    shm = NULL;
+  }
+  if (dev_buf != NULL) {
+    bs_trace_raw(3, "Device communication: %llu messages sent with %llu write() calls, "
+                 "%llu messages received with %llu read() calls\n",
+                 com_stats.msgs_out, com_stats.writes,
+                 com_stats.msgs_in, com_stats.reads);
+    if (com_stats.queued_reqs > 0) {
+      bs_trace_raw(3, "Device communication: %llu requests were received in request queues\n",
+                   com_stats.queued_reqs);
+    }
+    p2G4_shm_print_stats();
+    for (uint d = 0; d < n_devs; d++) {
+      free(dev_buf[d].out);
+      free(dev_buf[d].in);
+      free(dev_buf[d].q);
+    }
+    free(dev_buf);
+    dev_buf = NULL;
+  }
+  if (nofifo_connected != NULL) {
+    free(nofifo_connected);
+    nofifo_connected = NULL;
+  }
 }
 
 void p2G4_phy_resp_wait(uint d) {
-  pb_phy_resp_wait(&cb_med_state, d);
+  if (com_is_connected(d)) {
+    com_send_header(d, PB_MSG_WAIT_END);
+  }
+}
+
+/**
+ * Handle a device request to switch to the shared memory transport
+ * The response is sent thru the current transport, and only after that
+ * the device is switched to the new one.
+ */
+void p2G4_phy_shm_attach(uint d) {
+  p2G4_shm_attach_resp_t resp;
+  p2G4_shm_t *new_shm = NULL;
+
+  memset(&resp, 0, sizeof(resp));
+  resp.status = P2G4_SHM_ATTACH_NOTSUPP;
+
+  if (shm_allowed && !replaying && (shm[d] == NULL)) {
+    new_shm = p2G4_shm_create(d, &resp, cb_med_state.ff_dtp[d]);
+  }
+
+  com_send_msg(d, P2G4_MSG_SHM_ATTACH_RESP, &resp, sizeof(resp), NULL, 0);
+
+  if (new_shm != NULL) {
+    bs_trace_raw(5, "Device %u switched to shared memory transport (%s)\n", d, resp.name);
+    shm[d] = new_shm;
+  }
 }
 
 /**
  *  Respond to the device with P2G4_MSG_TX_END and the tx done structure
  */
 void p2G4_phy_resp_tx(uint d, p2G4_tx_done_t *tx_done_s) {
-  if (pb_phy_is_connected_to_device(&cb_med_state, d)) {
-    pb_send_msg(cb_med_state.ff_ptd[d], P2G4_MSG_TX_END,
-                (void *)tx_done_s, sizeof(p2G4_tx_done_t));
+  if (com_is_connected(d)) {
+    com_send_msg(d, P2G4_MSG_TX_END,
+                 (void *)tx_done_s, sizeof(p2G4_tx_done_t), NULL, 0);
   }
 }
 
@@ -42,10 +366,10 @@ void p2G4_phy_resp_tx(uint d, p2G4_tx_done_t *tx_done_s) {
  * p2G4_rx_done_t and a possible packet of p2G4_rx_done_t->packet_size bytes
  */
 void p2G4_phy_resp_rx_addr_found(uint d, p2G4_rx_done_t* rx_done_s, uint8_t *packet) {
-  if (pb_phy_is_connected_to_device(&cb_med_state, d)) {
-    pb_send_msg(cb_med_state.ff_ptd[d], P2G4_MSG_RX_ADDRESSFOUND,
-                (void *)rx_done_s, sizeof(p2G4_rx_done_t));
-    pb_send_payload(cb_med_state.ff_ptd[d], packet, rx_done_s->packet_size);
+  if (com_is_connected(d)) {
+    com_send_msg(d, P2G4_MSG_RX_ADDRESSFOUND,
+                 (void *)rx_done_s, sizeof(p2G4_rx_done_t),
+                 packet, rx_done_s->packet_size);
   }
 }
 
@@ -54,10 +378,10 @@ void p2G4_phy_resp_rx_addr_found(uint d, p2G4_rx_done_t* rx_done_s, uint8_t *pac
  * p2G4_rx_done_t and a possible packet of p2G4_rxv2_done_t->packet_size bytes
  */
 void p2G4_phy_resp_rxv2_addr_found(uint d, p2G4_rxv2_done_t* rx_done_s, uint8_t *packet) {
-  if (pb_phy_is_connected_to_device(&cb_med_state, d)) {
-    pb_send_msg(cb_med_state.ff_ptd[d], P2G4_MSG_RXV2_ADDRESSFOUND,
-                (void *)rx_done_s, sizeof(p2G4_rxv2_done_t));
-    pb_send_payload(cb_med_state.ff_ptd[d], packet, rx_done_s->packet_size);
+  if (com_is_connected(d)) {
+    com_send_msg(d, P2G4_MSG_RXV2_ADDRESSFOUND,
+                 (void *)rx_done_s, sizeof(p2G4_rxv2_done_t),
+                 packet, rx_done_s->packet_size);
   }
 }
 
@@ -66,9 +390,9 @@ void p2G4_phy_resp_rxv2_addr_found(uint d, p2G4_rxv2_done_t* rx_done_s, uint8_t
  * (note that the packet was already sent out in the address found)
  */
 void p2G4_phy_resp_rx(uint d, p2G4_rx_done_t* rx_done_s) {
-  if (pb_phy_is_connected_to_device(&cb_med_state, d)) {
-    pb_send_msg(cb_med_state.ff_ptd[d], P2G4_MSG_RX_END,
-                (void *)rx_done_s, sizeof(p2G4_rx_done_t));
+  if (com_is_connected(d)) {
+    com_send_msg(d, P2G4_MSG_RX_END,
+                 (void *)rx_done_s, sizeof(p2G4_rx_done_t), NULL, 0);
   }
 }
 
@@ -77,9 +401,9 @@ void p2G4_phy_resp_rx(uint d, p2G4_rx_done_t* rx_done_s) {
  * (note that the packet was already sent out in the address found)
  */
 void p2G4_phy_resp_rxv2(uint d, p2G4_rxv2_done_t* rx_done_s) {
-  if (pb_phy_is_connected_to_device(&cb_med_state, d)) {
-    pb_send_msg(cb_med_state.ff_ptd[d], P2G4_MSG_RXV2_END,
-                (void *)rx_done_s, sizeof(p2G4_rxv2_done_t));
+  if (com_is_connected(d)) {
+    com_send_msg(d, P2G4_MSG_RXV2_END,
+                 (void *)rx_done_s, sizeof(p2G4_rxv2_done_t), NULL, 0);
   }
 }
 
@@ -87,9 +411,9 @@ void p2G4_phy_resp_rxv2(uint d, p2G4_rxv2_done_t* rx_done_s) {
  * Respond to the device with P2G4_MSG_CCA_END and a p2G4_cca_done_t
  */
 void p2G4_phy_resp_cca(uint d, p2G4_cca_done_t *sc_done_s) {
-  if (pb_phy_is_connected_to_device(&cb_med_state, d)) {
-    pb_send_msg(cb_med_state.ff_ptd[d], P2G4_MSG_CCA_END,
-                (void *)sc_done_s, sizeof(p2G4_cca_done_t));
+  if (com_is_connected(d)) {
+    com_send_msg(d, P2G4_MSG_CCA_END,
+                 (void *)sc_done_s, sizeof(p2G4_cca_done_t), NULL, 0);
   }
 }
 
@@ -97,9 +421,9 @@ void p2G4_phy_resp_cca(uint d, p2G4_cca_done_t *sc_done_s) {
  * Respond to the device with P2G4_MSG_RSSI_END and a p2G4_rssi_done_t
  */
 void p2G4_phy_resp_RSSI(uint d, p2G4_rssi_done_t* RSSI_done_s) {
-  if (pb_phy_is_connected_to_device(&cb_med_state, d)) {
-    pb_send_msg(cb_med_state.ff_ptd[d], P2G4_MSG_RSSI_END,
-                (void *)RSSI_done_s, sizeof(p2G4_rssi_done_t));
+  if (com_is_connected(d)) {
+    com_send_msg(d, P2G4_MSG_RSSI_END,
+                 (void *)RSSI_done_s, sizeof(p2G4_rssi_done_t), NULL, 0);
   }
 }
 
@@ -109,65 +433,181 @@ void p2G4_phy_resp_RSSI(uint d, p2G4_rssi_done_t* RSSI_done_s) {
  * an immediate RSSI measurement)
  */
 void p2G4_phy_resp_IMRSSI(uint d, p2G4_rssi_done_t* RSSI_done_s) {
-  if (pb_phy_is_connected_to_device(&cb_med_state, d)) {
-    pb_send_msg(cb_med_state.ff_ptd[d], P2G4_MSG_IMMRSSI_RRSI_DONE,
-                (void *)RSSI_done_s, sizeof(p2G4_rssi_done_t));
+  if (com_is_connected(d)) {
+    com_send_msg(d, P2G4_MSG_IMMRSSI_RRSI_DONE,
+                 (void *)RSSI_done_s, sizeof(p2G4_rssi_done_t), NULL, 0);
+  }
+}
+
+/**
+ * Read <size> bytes of the request being processed
+ * (from the device request queue if it came from there)
+ */
+static ssize_t com_read_req(uint d, void *buf, size_t size) {
+  com_dev_buf_t *b = &dev_buf[d];
+
+  if (!b->q_reading) {
+    return com_read(d, buf, size);
+  }
+  if (b->q_end - b->q_start < size) {
+    bs_trace_error_line("Device %u queued request is truncated (needed %zu more bytes, %zu left in queue)\n",
+                        d, size, b->q_end - b->q_start);
+  }
+  memcpy(buf, &b->q[b->q_start], size);
+  b->q_start += size;
+  return size;
+}
+
+/**
+ * Read a P2G4_MSG_REQ_QUEUE content into the device queue
+ */
+static void com_get_req_queue(uint d) {
+  com_dev_buf_t *b = &dev_buf[d];
+  p2G4_req_queue_t rq;
+
+  if (b->q_reading) {
+    bs_trace_error_line("Device %u sent a request queue inside a request queue\n", d);
+  }
+  com_read(d, &rq, sizeof(rq));
+  if ((rq.n_bytes == 0) || (rq.n_bytes > P2G4_REQ_QUEUE_MAX_BYTES)) {
+    bs_trace_error_line("Device %u sent a request queue of %u bytes (must be 1..%u)\n",
+                        d, rq.n_bytes, P2G4_REQ_QUEUE_MAX_BYTES);
+  }
+  if (rq.n_bytes > b->q_size) {
+    b->q = bs_realloc(b->q, rq.n_bytes);
+    b->q_size = rq.n_bytes;
+  }
+  if (com_read(d, b->q, rq.n_bytes) != rq.n_bytes) {
+    b->q_start = b->q_end = 0;
+    return; //The device is gone, we will notice when reading its next header
+  }
+  b->q_start = 0;
+  b->q_end = rq.n_bytes;
+}
+
+/**
+ * Read the next header from the transport (not from the request queue)
+ * and handle disconnections
+ */
+static pc_header_t com_get_header(uint d){
+  pc_header_t header = PB_MSG_DISCONNECT;
+  ssize_t read_size;
+
+  read_size = com_read(d, &header, sizeof(header));
+  com_stats.msgs_in++;
+
+  if (read_size != sizeof(header)) {
+    bs_trace_warning_line("Low level communication with device %u broken (tried to get %i got %i bytes) (most likely the device was terminated)\n",
+                          d, (int)sizeof(header), (int)read_size);
+    header = PB_MSG_DISCONNECT;
+  }
+  if (header == PB_MSG_DISCONNECT) {
+    com_free_one_device(d);
   }
+  return header;
 }
 
+/**
+ * Get the next request from the device
+ * (from its request queue if it has requests pending there)
+ */
 pc_header_t p2G4_get_next_request(uint d){
-  return pb_phy_get_next_request(&cb_med_state, d);
+  com_dev_buf_t *b = &dev_buf[d];
+  pc_header_t header;
+
+  b->q_reading = false;
+
+  if (b->q_start == b->q_end) {
+    header = com_get_header(d);
+    if (header != P2G4_MSG_REQ_QUEUE) {
+      return header;
+    }
+    com_get_req_queue(d);
+    if (b->q_start == b->q_end) {
+      return com_get_header(d);
+    }
+  }
+
+  b->q_reading = true;
+  com_read_req(d, &header, sizeof(header));
+  com_stats.queued_reqs++;
+  if (header == PB_MSG_DISCONNECT) {
+    b->q_start = b->q_end = 0; //Nothing after it can be valid
+    b->q_reading = false;
+    com_free_one_device(d);
+  }
+  return header;
+}
+
+/**
+ * Get a response from the device during an ongoing operation
+ * (e.g. after an address found). This never comes from the request queue
+ */
+pc_header_t p2G4_get_device_response(uint d){
+  dev_buf[d].q_reading = false;
+  return com_get_header(d);
 }
 
 void p2G4_phy_get(uint d, void* b, size_t size) {
-  if (pb_phy_is_connected_to_device(&cb_med_state, d)) {
-    read(cb_med_state.ff_dtp[d], b, size);
+  if (com_is_connected(d)) {
+    com_read_req(d, b, size);
   }
 }
 
 
 /**
- * Get abort structure from device
+ * Get <size> bytes of an abort reevaluation response from device <d>
+ * (if the device is gone, disconnect all devices and exit)
  */
-void p2G4_phy_get_abort_struct(uint d, p2G4_abort_t* abort_s) {
+void p2G4_phy_get_abort_data(uint d, void *buf, size_t size) {
   ssize_t read_size = 0;
-  read_size = read(cb_med_state.ff_dtp[d], abort_s, sizeof(p2G4_abort_t));
+  read_size = com_read(d, buf, size);
 
-  if (read_size != sizeof(p2G4_abort_t)) {
+  if (read_size != size) {
     //There is some likelihood that a device will crash badly during abort
     //reevaluation, therefore we try to handle it
     bs_trace_warning_line(
-        "Low level communication with device %i broken during Abort reevaluation (tried to get %i got %i bytes) (most likely the device was terminated)\n",
-        d, sizeof(p2G4_abort_t), read_size);
-    pb_phy_disconnect_devices(&cb_med_state);
+        "Low level communication with device %i broken during Abort reevaluation (tried to get %zu got %zd bytes) (most likely the device was terminated)\n",
+        d, size, read_size);
+    com_disconnect_devices();
     bs_trace_error_line("Exiting\n");
   }
 }
 
+/**
+ * Get abort structure from device
+ */
+void p2G4_phy_get_abort_struct(uint d, p2G4_abort_t* abort_s) {
+  p2G4_phy_get_abort_data(d, abort_s, sizeof(p2G4_abort_t));
+}
+
 /**
  * Ask the device for a new abort struct for the ongoing Tx or Rx
  */
 void p2G4_phy_get_new_abort_request(uint d){
-  if (pb_phy_is_connected_to_device(&cb_med_state, d)) {
-    pc_header_t r_header = P2G4_MSG_ABORTREEVAL;
-    write(cb_med_state.ff_ptd[d], &r_header, sizeof(r_header));
+  dev_buf[d].q_reading = false; //What follows comes from the device itself
+  if (com_is_connected(d)) {
+    com_send_header(d, P2G4_MSG_ABORTREEVAL);
   }
 }
 /**
  * Pick the new abort response from the device (or something else)
  */
 int p2G4_phy_get_new_abort_receive(uint d, p2G4_abort_t* abort_s) {
-  if (pb_phy_is_connected_to_device(&cb_med_state, d)) {
+  if (com_is_connected(d)) {
     pc_header_t header = PB_MSG_DISCONNECT;
-    read(cb_med_state.ff_dtp[d], &header, sizeof(header));
+    com_read(d, &header, sizeof(header));
+    com_stats.msgs_in++;
 
     if (header == PB_MSG_TERMINATE) {
       return PB_MSG_TERMINATE;
     } else if (header == PB_MSG_DISCONNECT) {
-      pb_phy_free_one_device(&cb_med_state ,d);
+      com_free_one_device(d);
       return PB_MSG_DISCONNECT;
     } else if (header == P2G4_MSG_RERESP_IMMRSSI) {
       return P2G4_MSG_RERESP_IMMRSSI;
+    } else if (header == P2G4_MSG_RERESP_ABORT_SCHED) {
+      return P2G4_MSG_RERESP_ABORT_SCHED;
     } else if (header != P2G4_MSG_RERESP_ABORTREEVAL) {
       //if we get another response, the device is misbehaving => let's terminate the simulation
       bs_trace_warning_line("Device %i sent invalid response during abort reevaluation (%u) => Terminating\n",
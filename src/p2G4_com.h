@@ -13,7 +13,29 @@
 extern "C"{
 #endif
 
-void p2G4_phy_initcom(const char* s, const char* p, uint n);
+/**
+ * Request queues
+ *
+ * Instead of sending one request and waiting for its response before
+ * sending the next one, a device may send a P2G4_MSG_REQ_QUEUE header
+ * followed by a p2G4_req_queue_t and n_bytes containing one or several
+ * complete requests (each exactly as it would have been sent on its own,
+ * e.g. a Tx, then a Wait, then an Rx).
+ * The Phy will process them one after the other without waiting for the
+ * device in between, sending each response as usual.
+ * Any interaction during an operation (abort reevaluations, the address
+ * found continuation of an Rx, immediate RSSI measurements) still happens
+ * synchronously with the device.
+ * After the last queued request, the Phy waits for the device next request.
+ */
+#define P2G4_MSG_REQ_QUEUE 0x7003
+#define P2G4_REQ_QUEUE_MAX_BYTES (64*1024)
+
+typedef struct {
+  uint32_t n_bytes;
+} p2G4_req_queue_t;
+
+void p2G4_phy_initcom(const char* s, const char* p, uint n, bool allow_shm, uint spin);
 void p2G4_phy_disconnect_all_devices();
 void p2G4_phy_resp_rx(uint d, p2G4_rx_done_t* rx_d);
 void p2G4_phy_resp_rxv2(uint d, p2G4_rxv2_done_t* rx_done_s);
@@ -24,11 +46,14 @@ void p2G4_phy_resp_rx_addr_found(uint d, p2G4_rx_done_t* rx_d, uint8_t *p);
 void p2G4_phy_resp_rxv2_addr_found(uint d, p2G4_rxv2_done_t* rx_done_s, uint8_t *packet);
 void p2G4_phy_resp_cca(uint d, p2G4_cca_done_t *sc_done_s);
 void p2G4_phy_resp_wait(uint d);
+void p2G4_phy_shm_attach(uint d);
 void p2G4_phy_get(uint d, void* b, size_t size);
 void p2G4_phy_get_new_abort_request(uint d);
 int p2G4_phy_get_new_abort_receive(uint d, p2G4_abort_t* abort);
-int p2G4_phy_get_abort_struct(uint d, p2G4_abort_t* abort_s);
+void p2G4_phy_get_abort_struct(uint d, p2G4_abort_t* abort_s);
+void p2G4_phy_get_abort_data(uint d, void *buf, size_t size);
 pc_header_t p2G4_get_next_request(uint d);
+pc_header_t p2G4_get_device_response(uint d);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,227 @@
+/*
+ * Copyright 2026 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Shared memory transport between the Phy and a device (see p2G4_com_shm.h)
+ */
+
+#define _GNU_SOURCE
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include "bs_types.h"
+#include "bs_tracing.h"
+#include "bs_oswrap.h"
+#include "bs_utils.h"
+#include "p2G4_com_shm.h"
+
+/* How long we wait in the futex before checking if the device is still there */
+#define SHM_LIVENESS_CHECK_NS 100000000
+
+/* How many times we poll a ring index before blocking in the futex */
+static uint spin_iterations = 0;
+
+static struct {
+  unsigned long long spin_hits; /* Waits resolved while spinning */
+  unsigned long long blocks;    /* Waits which went to the futex */
+} wait_stats;
+
+struct p2G4_shm_s {
+  p2G4_shm_region_t *region;
+  char name[P2G4_SHM_NAME_MAX];
+  int live_fd;
+};
+
+static int futex_wait(uint32_t *addr, uint32_t val, const struct timespec *timeout) {
+  return syscall(SYS_futex, addr, FUTEX_WAIT, val, timeout, NULL, 0);
+}
+
+static void futex_wake(uint32_t *addr) {
+  syscall(SYS_futex, addr, FUTEX_WAKE, 1, NULL, NULL, 0);
+}
+
+/**
+ * Has the device closed its side of the FIFO (crashed or exited)
+ */
+static bool peer_gone(int live_fd) {
+  struct pollfd pfd = { .fd = live_fd, .events = POLLIN };
+
+  if (poll(&pfd, 1, 0) > 0) {
+    return (pfd.revents & (POLLHUP | POLLERR | POLLNVAL)) != 0;
+  }
+  return false;
+}
+
+static inline void cpu_relax(void) {
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#elif defined(__aarch64__)
+  __asm__ __volatile__("yield");
+#endif
+}
+
+/**
+ * Wait until *index changes from <old>
+ * Returns 0 if it changed (or we just should retry), -1 if the device is gone
+ */
+static int wait_index_change(uint32_t *index, uint32_t old, uint32_t *waiting_flag, int live_fd) {
+  const struct timespec timeout = {0, SHM_LIVENESS_CHECK_NS};
+  int ret = 0;
+
+  for (uint i = 0; i < spin_iterations; i++) {
+    if (__atomic_load_n(index, __ATOMIC_ACQUIRE) != old) {
+      wait_stats.spin_hits++;
+      return 0;
+    }
+    cpu_relax();
+  }
+  wait_stats.blocks++;
+
+  __atomic_store_n(waiting_flag, 1, __ATOMIC_SEQ_CST);
+  if (__atomic_load_n(index, __ATOMIC_SEQ_CST) == old) {
+    if ((futex_wait(index, old, &timeout) == -1) && (errno == ETIMEDOUT)) {
+      if (peer_gone(live_fd)) {
+        ret = -1;
+      }
+    }
+  }
+  __atomic_store_n(waiting_flag, 0, __ATOMIC_SEQ_CST);
+  return ret;
+}
+
+void p2G4_shm_set_spin(uint iterations) {
+  spin_iterations = iterations;
+}
+
+void p2G4_shm_print_stats(void) {
+  if (wait_stats.spin_hits + wait_stats.blocks > 0) {
+    bs_trace_raw(3, "Shared memory transport: %llu waits resolved spinning, %llu blocked\n",
+                 wait_stats.spin_hits, wait_stats.blocks);
+  }
+}
+
+p2G4_shm_t *p2G4_shm_create(uint d, p2G4_shm_attach_resp_t *resp, int live_fd) {
+  p2G4_shm_t *shm;
+  int fd;
+
+  shm = bs_calloc(1, sizeof(p2G4_shm_t));
+  snprintf(shm->name, P2G4_SHM_NAME_MAX, "/bs_p2G4_%i_%u", (int)getpid(), d);
+  shm->live_fd = live_fd;
+
+  fd = shm_open(shm->name, O_RDWR | O_CREAT | O_EXCL, 0600);
+  if (fd == -1) {
+    bs_trace_warning_line("Could not create shared memory object %s for device %u (%s)\n",
+                          shm->name, d, strerror(errno));
+    free(shm);
+    return NULL;
+  }
+  if (ftruncate(fd, sizeof(p2G4_shm_region_t)) != 0) {
+    bs_trace_warning_line("Could not size shared memory object %s (%s)\n",
+                          shm->name, strerror(errno));
+    close(fd);
+    shm_unlink(shm->name);
+    free(shm);
+    return NULL;
+  }
+  shm->region = mmap(NULL, sizeof(p2G4_shm_region_t), PROT_READ | PROT_WRITE,
+                     MAP_SHARED, fd, 0);
+  close(fd);
+  if (shm->region == MAP_FAILED) {
+    bs_trace_warning_line("Could not map shared memory object %s (%s)\n",
+                          shm->name, strerror(errno));
+    shm_unlink(shm->name);
+    free(shm);
+    return NULL;
+  }
+
+  shm->region->ring_size = P2G4_SHM_RING_SIZE;
+  shm->region->version = P2G4_SHM_VERSION;
+  __atomic_store_n(&shm->region->magic, P2G4_SHM_MAGIC, __ATOMIC_RELEASE);
+
+  resp->status = P2G4_SHM_ATTACH_OK;
+  memcpy(resp->name, shm->name, P2G4_SHM_NAME_MAX);
+
+  return shm;
+}
+
+int p2G4_shm_read(p2G4_shm_t *shm, void *buf, size_t size) {
+  p2G4_shm_ring_t *r = &shm->region->dtp;
+  uint8_t *b = buf;
+
+  while (size > 0) {
+    uint32_t tail = r->tail;
+    uint32_t head = __atomic_load_n(&r->head, __ATOMIC_ACQUIRE);
+    uint32_t n = head - tail;
+
+    if (n == 0) {
+      if (wait_index_change(&r->head, head, &r->cons_waiting, shm->live_fd) != 0) {
+        return -1;
+      }
+      continue;
+    }
+    n = BS_MIN(n, size);
+
+    uint32_t idx = tail & (P2G4_SHM_RING_SIZE - 1);
+    uint32_t first = BS_MIN(n, P2G4_SHM_RING_SIZE - idx);
+    memcpy(b, &r->data[idx], first);
+    memcpy(b + first, r->data, n - first);
+
+    __atomic_store_n(&r->tail, tail + n, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&r->prod_waiting, __ATOMIC_SEQ_CST)) {
+      futex_wake(&r->tail);
+    }
+    b += n;
+    size -= n;
+  }
+  return 0;
+}
+
+int p2G4_shm_write(p2G4_shm_t *shm, const void *buf, size_t size) {
+  p2G4_shm_ring_t *r = &shm->region->ptd;
+  const uint8_t *b = buf;
+
+  while (size > 0) {
+    uint32_t head = r->head;
+    uint32_t tail = __atomic_load_n(&r->tail, __ATOMIC_ACQUIRE);
+    uint32_t n = P2G4_SHM_RING_SIZE - (head - tail);
+
+    if (n == 0) {
+      if (wait_index_change(&r->tail, tail, &r->prod_waiting, shm->live_fd) != 0) {
+        return -1;
+      }
+      continue;
+    }
+    n = BS_MIN(n, size);
+
+    uint32_t idx = head & (P2G4_SHM_RING_SIZE - 1);
+    uint32_t first = BS_MIN(n, P2G4_SHM_RING_SIZE - idx);
+    memcpy(&r->data[idx], b, first);
+    memcpy(r->data, b + first, n - first);
+
+    __atomic_store_n(&r->head, head + n, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&r->cons_waiting, __ATOMIC_SEQ_CST)) {
+      futex_wake(&r->head);
+    }
+    b += n;
+    size -= n;
+  }
+  return 0;
+}
+
+void p2G4_shm_delete(p2G4_shm_t *shm) {
+  if (shm == NULL) {
+    return;
+  }
+  munmap(shm->region, sizeof(p2G4_shm_region_t));
+  shm_unlink(shm->name);
+  free(shm);
+}
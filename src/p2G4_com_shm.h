@@ -0,0 +1,129 @@
+/*
+ * Copyright 2026 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#ifndef P2G4_COM_SHM_H
+#define P2G4_COM_SHM_H
+
+#include "bs_types.h"
+#include "bs_pc_base_types.h"
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/**
+ * Shared memory transport between the Phy and a device
+ *
+ * By default all communication with the devices goes thru a pair of FIFOs
+ * (see libPhyComv1). A device may instead request to switch to a shared
+ * memory transport, by sending, as any other request, a P2G4_MSG_SHM_ATTACH
+ * header (without any further content).
+ * The Phy will respond, still thru the FIFO, with a P2G4_MSG_SHM_ATTACH_RESP
+ * header followed by a p2G4_shm_attach_resp_t.
+ * If the status is P2G4_SHM_ATTACH_OK, the Phy has created a POSIX shared
+ * memory object with that name (containing a p2G4_shm_region_t), and from
+ * then on, all messages in both directions will be sent thru its two rings,
+ * with the same content and order as they would have been sent thru the FIFOs.
+ * Otherwise (the Phy does not support it, or it is disabled) the device shall
+ * just continue using the FIFOs.
+ *
+ * Each ring is a single producer single consumer byte queue.
+ * The producer only writes head, the consumer only writes tail.
+ * When a side needs to wait, it sets its waiting flag, rechecks the index,
+ * and waits in a futex on the other side index. After updating its index,
+ * each side wakes the other if its waiting flag is set.
+ *
+ * Optionally each side may first spin for a while polling the index before
+ * blocking in the futex. When both the Phy and the device are pinned to
+ * dedicated cores this avoids the scheduler wake up latency in each handoff.
+ *
+ * The device shall keep its FIFOs open until it disconnects, as they are
+ * still used to detect if the device has crashed.
+ */
+
+#define P2G4_MSG_SHM_ATTACH      0x7001
+#define P2G4_MSG_SHM_ATTACH_RESP 0x7081
+
+#define P2G4_SHM_ATTACH_OK    0
+#define P2G4_SHM_ATTACH_NOTSUPP 1
+
+#define P2G4_SHM_NAME_MAX 64
+#define P2G4_SHM_MAGIC 0x50324734
+#define P2G4_SHM_VERSION 1
+#define P2G4_SHM_RING_SIZE (64*1024) /* Must be a power of 2 */
+
+typedef struct {
+  uint32_t status;
+  char name[P2G4_SHM_NAME_MAX];
+} p2G4_shm_attach_resp_t;
+
+typedef struct {
+  uint32_t head; /* Bytes written so far by the producer (modulo 2^32) */
+  uint32_t cons_waiting; /* The consumer is waiting for head to change */
+  uint8_t pad0[56];
+  uint32_t tail; /* Bytes read so far by the consumer (modulo 2^32) */
+  uint32_t prod_waiting; /* The producer is waiting for tail to change */
+  uint8_t pad1[56];
+  uint8_t data[P2G4_SHM_RING_SIZE];
+} p2G4_shm_ring_t;
+
+typedef struct {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t ring_size;
+  uint8_t pad[52];
+  p2G4_shm_ring_t ptd; /* Phy to device */
+  p2G4_shm_ring_t dtp; /* Device to phy */
+} p2G4_shm_region_t;
+
+typedef struct p2G4_shm_s p2G4_shm_t;
+
+/**
+ * Create the shared memory region for device <d>
+ *
+ * @param d Device number
+ * @param resp Attach response, where the object name will be written
+ * @param live_fd File descriptor of the device to Phy FIFO, which will be
+ *        used to detect if the device is gone while waiting
+ * @return Handle to the region or NULL on failure
+ */
+p2G4_shm_t *p2G4_shm_create(uint d, p2G4_shm_attach_resp_t *resp, int live_fd);
+
+/**
+ * Read <size> bytes from the device
+ * Blocks until all have been received
+ *
+ * @return 0 on success, -1 if the device is gone
+ */
+int p2G4_shm_read(p2G4_shm_t *shm, void *buf, size_t size);
+
+/**
+ * Write <size> bytes to the device
+ * Blocks until all have been queued
+ *
+ * @return 0 on success, -1 if the device is gone
+ */
+int p2G4_shm_write(p2G4_shm_t *shm, const void *buf, size_t size);
+
+/**
+ * Unmap and remove the shared memory region
+ */
+void p2G4_shm_delete(p2G4_shm_t *shm);
+
+/**
+ * Set for how many iterations we poll a ring before blocking (0 = never spin)
+ */
+void p2G4_shm_set_spin(uint iterations);
+
+/**
+ * Print how many waits were resolved while spinning vs blocking
+ */
+void p2G4_shm_print_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
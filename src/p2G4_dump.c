@@ -5,735 +5,685 @@
  */
 #include <string.h>
 #include <stdio.h>
+#include <unistd.h>
 #include "bs_tracing.h"
 #include "bs_oswrap.h"
+#include "bs_utils.h"
 #include "bs_results.h"
 #include "bs_pc_2G4_types.h"
 #include "bs_pc_2G4_utils.h"
 #include "p2G4_channel_and_modem_priv.h"
 #include "bs_rand_main.h"
 #include "p2G4_pending_tx_rx_list.h"
-
-/*Max number of errors before ignoring a given file*/
-#define MAX_ERRORS 15
-
-static bool comp, stop_on_diff;
+#include "p2G4_dump.h"
+#include "p2G4_dump_rec.h"
+#include "p2G4_dump_format.h"
+#include "p2G4_dump_bin.h"
+#include "p2G4_dump_writer.h"
+#include "p2G4_dump_cmp.h"
+#include "p2G4_dump_digest.h"
+#include "p2G4_dump_z.h"
+#include "p2G4_dump_filter.h"
+#include "p2G4_dump_idx.h"
+
+/*Size of the ring between the simulation and the dump writer thread*/
+#define DUMP_RING_SIZE (8*1024*1024)
+
+static bool comp, stop_on_diff, binary, dump_imm, digest, mux, compress, modemrx_sparse;
+/* Between open_dump_files() and close_dump_files() (not set with -nodump) */
+static bool dumping = false;
+/* Digest manifest (in digest mode) */
+static char *digest_file = NULL;
 static uint n_dev = 0;
+/* Time index period (0 = no indexes) */
+static bs_time_t idx_period = 0;
+/* Number of files of each type: one per device, or just one if multiplexed */
+static uint n_slots = 0;
+/* "<results_path>/d_<p_id>" for the multiplexed files */
+static char *mux_prefix = NULL;
+/*
+ * Multiplexed files not yet created (they are created with their first record)
+ * (only used where the records are written, that is, in the writer thread if
+ * it is running)
+ */
+static bool pending[P2G4_DF_N];
+static bool bin_pending[P2G4_DS_N];
+/*
+ * Which files are dumped (or compared), per type and device. Only set while
+ * opening, before the writer thread starts, so both threads can read them
+ */
+static bool *sel[P2G4_DF_N];
+static bool *bin_sel[P2G4_DS_N];
+
+/* CSV files, per type and device */
+static FILE **files[P2G4_DF_N];
+/* Binary dump files, per stream and device */
+static FILE **bin_files[P2G4_DS_N];
+/* In compare mode, comparisons against the CSV or binary reference files instead */
+static dcmp_t **cmps[P2G4_DF_N];
+static dcmp_t **bin_cmps[P2G4_DS_N];
+/* Time indexes of the CSV and binary dump files (if enabled) */
+static didx_t **idxs[P2G4_DF_N];
+static didx_t **bin_idxs[P2G4_DS_N];
+
+/* CSV files each stream is dumped into */
+static const int stream_files[P2G4_DS_N][2] = {
+  { P2G4_DF_TXV1, P2G4_DF_TXV2 },
+  { P2G4_DF_RXV1, P2G4_DF_RXV2 },
+  { P2G4_DF_RSSI, -1 },
+  { P2G4_DF_CCA, -1 },
+  { P2G4_DF_MODEMRX, P2G4_DF_MODEMRXS },
+};
+
+/* Buffer in which lines are formatted (grown as needed) */
+static char *line = NULL;
+static size_t line_size = 0;
+
+/* Active transmitters of the ModemRx record being dumped */
+static p2G4_drec_modemrx_tx_t *modemrx_txs = NULL;
+
+static void dump_record_sink(p2G4_dump_stream_t stream, const p2G4_drec_hdr_t *rec,
+                             const void *var);
 
-/* statistics per device and file */
-typedef struct {
-  //Number of lines with errors:
-  uint32_t nbr_rxv1_er;
-  uint32_t nbr_txv1_er;
-  uint32_t nbr_rxv2_er;
-  uint32_t nbr_txv2_er;
-  uint32_t nbr_RSSI_er;
-  uint32_t nbr_CCA_er;
-  uint32_t nbr_modemrx_er;
-  //Number lines dumped:
-  uint32_t nbr_rxv1;
-  uint32_t nbr_txv1;
-  uint32_t nbr_rxv2;
-  uint32_t nbr_txv2;
-  uint32_t nbr_RSSI;
-  uint32_t nbr_CCA;
-  uint32_t nbr_modemrx;
-} t_dump_check_stats;
-
-static t_dump_check_stats *stats = NULL;
-
-static FILE **txv1_f = NULL;
-static FILE **rxv1_f = NULL;
-static FILE **txv2_f = NULL;
-static FILE **rxv2_f = NULL;
-static FILE **RSSI_f = NULL;
-static FILE **CCA_f = NULL;
-static FILE **modemrx_f = NULL;
-
-static void dump_txv1_heading(FILE *file){
-  if (file == NULL) {
-    return;
-  }
-  fprintf(file,
-          "start_time,end_time,center_freq,"
-          "phy_address,modulation,power_level,abort_time,"
-          "recheck_time,packet_size,packet\n");
-}
-
-static void dump_txv2_heading(FILE *file){
-  if (file == NULL) {
-    return;
-  }
-  fprintf(file,
-            "start_tx_time,end_tx_time,"
-            "start_packet_time, end_packet_time, center_freq,"
-            "phy_address,modulation,coding_rate,power_level,abort_time,"
-            "recheck_time,packet_size,packet\n");
-}
-
-static void dump_rxv1_heading(FILE *file){
-  if (file == NULL) {
-    return;
-  }
-  fprintf(file,"start_time,scan_duration,phy_address,modulation,"
-               "center_freq,antenna_gain,sync_threshold,header_threshold,"
-               "pream_and_addr_duration,"
-               "header_duration,bps,abort_time,recheck_time,"
-               "tx_nbr,biterrors,sync_end,header_end,"
-               "payload_end,rx_time_stamp,status,RSSI,"
-               "packet_size,packet\n");
-}
-
-static void dump_rxv2_heading(FILE *file){
-  if (file == NULL) {
-    return;
-  }
-  fprintf(file,"start_time,scan_duration,n_addr,phy_address[],modulation,"
-               "center_freq,antenna_gain,"
-               "acceptable_pre_truncation,sync_threshold,header_threshold,"
-               "pream_and_addr_duration,"
-               "header_duration,error_calc_rate,"
-               "forced_packet_duration,coding_rate,prelocked_tx,"
-               "resp_type,"
-               "abort_time,recheck_time,"
-               "tx_nbr,matched_addr,tx_coding_rate,biterrors,sync_end,header_end,"
-               "payload_end,rx_time_stamp,status,RSSI,"
-               "packet_size,packet\n");
-}
-
-static void dump_CCA_heading(FILE *file){
-  if (file == NULL) {
-    return;
-  }
-  fprintf(file,"start_time,scan_duration,scan_period,"
-      "modulation,center_freq,antenna_gain,"
-      "threshold_mod,threshold_rssi,stop_when_found,"
-      "abort_time,recheck_time,"
-      "end_time, RSSI_ave, RSSI_max, mod_rx_power,"
-      "mod_found, rssi_overthreshold\n");
-}
-
+/**
+ * Create a dump file (compressed, with a .gz suffix, if so configured)
+ */
+static FILE* open_file(const char *filename) {
+  FILE *file;
 
-static void dump_RSSI_heading(FILE *file){
-  if (file == NULL) {
-    return;
+  if (compress) {
+    char gz_name[strlen(filename) + 4];
+    sprintf(gz_name, "%s.gz", filename);
+    return dz_fopen(gz_name);
   }
-  fprintf(file,"meas_time,modulation,center_freq,antenna_gain,RSSI\n");
-}
 
-static void dump_modemrx_heading(FILE *file){
-  if (file == NULL) {
-    return;
+  file = bs_fopen(filename, "w");
+  if (dump_imm) {
+    setvbuf(file, NULL, _IOLBF, 0);
   }
-  fprintf(file,"time,tx_nbr,CalNotRecal,center_freq,modulation,"
-               "coding_rate,"
-               "BER,syncprob,SNR,anaSNR,ISISNR,att[i],rxpow[i]\n");
+  return file;
 }
 
 /**
- * Compare 2 strings, return 0 if they match,
- * or -(the position of the 1st difference if they don't)
+ * Start the time index of a dump file (if enabled)
  */
-static int compare(const char* a,const char* b, size_t size){
-  int i = 0;
-  while ( i < size && ( ( a[i] != 0 ) || ( b[i]!= 0 ) ) ){
-    if (a[i] != b[i]){
-      return -(i+1);
-    }
-    i++;
+static didx_t *open_idx(const char *filename) {
+  if (idx_period == 0) {
+    return NULL;
   }
-  return 0;
+  return didx_open(filename, idx_period);
 }
 
-static void generate_cursor(char *o, const uint n){
-  int i = 0;
-  while (i < n-1){
-    o[i++] =' ';
-  }
-  o[i++]='^';
-  o[i]=0;
-}
+static FILE* open_bin_file(const char *filename, p2G4_dump_stream_t stream, uint dev) {
+  FILE *file = open_file(filename);
 
-static FILE* open_file(size_t fname_len, const char* results_path, const char* type,
-                       const char* p_id, int dev_nbr) {
-  FILE *file;
-  char filename[fname_len];
-  sprintf(filename,"%s/d_%s_%02i.%s.csv",results_path, p_id, dev_nbr, type);
-
-  if (comp == 1) {
-    file = bs_fopen(filename, "r");
-    bs_skipline(file); //Skip heading
-    if ( feof(file) ){
-      bs_trace_warning_line("%s file for device %i empty => won't be checked\n",type, dev_nbr);
-      fclose(file);
-      file = NULL;
-    }
-  } else {
-    file = bs_fopen(filename, "w");
-  }
+  dbin_write_header(file, stream, dev, n_dev);
   return file;
 }
 
 /**
  * Prepare dumping
  */
-void open_dump_files(uint8_t comp_i, uint8_t stop, uint8_t dump_imm, const char* s,
-                     const char* p, const uint n_dev_i){
+void open_dump_files(const p2G4_dump_cfg_t *cfg){
   char* path;
+  const char *p = cfg->p_id;
+
+  comp = cfg->compare;
+  stop_on_diff = cfg->stop_on_diff;
+  dump_imm = cfg->dump_imm;
+  binary = cfg->binary;
+  digest = cfg->digest;
+  mux = cfg->mux;
+  compress = cfg->compress && !comp;
+  modemrx_sparse = cfg->modemrx_sparse;
+  n_dev = cfg->n_devs;
+  n_slots = mux ? 1 : n_dev;
+  idx_period = (comp || digest) ? 0 : cfg->idx_period;
+
+  if (cfg->compress && !dz_available()) {
+    bs_trace_warning_line("The Phy was built without compression support, "
+                          "dumping uncompressed\n");
+    compress = false;
+  }
+  if (compress && (idx_period > 0)) {
+    bs_trace_warning_line("Compressed dumps can not be indexed, "
+                          "no time indexes will be written\n");
+    idx_period = 0;
+  }
+
+  path = bs_create_result_folder(cfg->s_id);
+
+  modemrx_txs = bs_calloc(n_dev, sizeof(p2G4_drec_modemrx_tx_t));
+  dflt_init(&cfg->filter, n_dev);
+  dumping = true;
+
+  if (digest) {
+    digest_file = bs_calloc(strlen(path) + strlen(p) + 16, 1);
+    sprintf(digest_file, "%s/d_%s.digest", path, p);
+    ddig_init(n_dev, cfg->digest_cp);
+    free(path);
+    return;
+  }
 
-  comp = comp_i;
-  stop_on_diff = stop;
-  n_dev = n_dev_i;
-
-  path = bs_create_result_folder(s);
+  int fname_len = 26 + strlen(path) + strlen(p);
+  char filename[fname_len];
 
-  stats = bs_calloc(n_dev, sizeof(t_dump_check_stats));
-  txv1_f = bs_calloc(n_dev, sizeof(FILE *));
-  rxv1_f = bs_calloc(n_dev, sizeof(FILE *));
-  txv2_f = bs_calloc(n_dev, sizeof(FILE *));
-  rxv2_f = bs_calloc(n_dev, sizeof(FILE *));
-  RSSI_f = bs_calloc(n_dev, sizeof(FILE *));
-  CCA_f  = bs_calloc(n_dev, sizeof(FILE *));
-  modemrx_f = bs_calloc(n_dev, sizeof(FILE *));
+  if (mux) {
+    mux_prefix = bs_calloc(fname_len, 1);
+    sprintf(mux_prefix, "%s/d_%s", path, p);
+  }
 
-  int fname_len = 26 + strlen(path) + strlen(p);
-  for (int i = 0; i < n_dev; i++) {
-    txv1_f[i] = open_file(fname_len, path, "Tx", p, i);
-    rxv1_f[i] = open_file(fname_len, path, "Rx", p, i);
-    txv2_f[i] = open_file(fname_len, path, "Txv2", p, i);
-    rxv2_f[i] = open_file(fname_len, path, "Rxv2", p, i);
-    CCA_f[i]  = open_file(fname_len, path, "CCA", p, i);
-    RSSI_f[i] = open_file(fname_len, path, "RSSI", p, i);
-    modemrx_f[i] = open_file(fname_len, path, "ModemRx", p, i);
-
-    if (comp == 0) {
-      if (dump_imm) {
-        if (txv1_f[i]) setvbuf(txv1_f[i], NULL, _IOLBF, 0);
-        if (rxv1_f[i]) setvbuf(rxv1_f[i], NULL, _IOLBF, 0);
-        if (txv2_f[i]) setvbuf(txv2_f[i], NULL, _IOLBF, 0);
-        if (rxv2_f[i]) setvbuf(rxv2_f[i], NULL, _IOLBF, 0);
-        if (RSSI_f[i]) setvbuf(RSSI_f[i], NULL, _IOLBF, 0);
-        if (CCA_f[i]) setvbuf(CCA_f[i] , NULL, _IOLBF, 0);
-        if (modemrx_f[i]) setvbuf(modemrx_f[i], NULL, _IOLBF, 0);
+  if (binary) {
+    for (int st = 0; st < P2G4_DS_N; st++) {
+      bin_sel[st] = bs_calloc(n_slots, sizeof(bool));
+      if (comp) {
+        bin_cmps[st] = bs_calloc(n_slots, sizeof(dcmp_t *));
+      } else {
+        bin_files[st] = bs_calloc(n_slots, sizeof(FILE *));
+        bin_idxs[st] = bs_calloc(n_slots, sizeof(didx_t *));
+      }
+      if (mux) {
+        sprintf(filename,"%s.%s.bin", mux_prefix, dbin_stream_name[st]);
+        if (!dflt_stream_selected(st)) {
+          continue;
+        } else if (!comp) {
+          bin_pending[st] = true;
+          bin_sel[st][0] = true;
+        } else if (access(filename, F_OK) == 0) {
+          bin_cmps[st][0] = dcmp_open_bin(filename, st, -1, stop_on_diff);
+          bin_sel[st][0] = (bin_cmps[st][0] != NULL);
+        } else {
+          bs_trace_warning_line("%s does not exist => won't be checked\n", filename);
+        }
+        continue;
+      }
+      for (int i = 0; i < n_dev; i++) {
+        if (!dflt_selected(i, st)) {
+          continue;
+        }
+        sprintf(filename,"%s/d_%s_%02i.%s.bin", path, p, i, dbin_stream_name[st]);
+        if (comp) {
+          bin_cmps[st][i] = dcmp_open_bin(filename, st, i, stop_on_diff);
+          bin_sel[st][i] = (bin_cmps[st][i] != NULL);
+        } else {
+          bin_files[st][i] = open_bin_file(filename, st, i);
+          bin_idxs[st][i] = open_idx(filename);
+          bin_sel[st][i] = true;
+        }
+      }
+    }
+  } else {
+    for (int f = 0; f < P2G4_DF_N; f++) {
+      /* ModemRx is dumped in either the dense or the sparse format */
+      if ((f == P2G4_DF_MODEMRX && modemrx_sparse)
+          || (f == P2G4_DF_MODEMRXS && !modemrx_sparse)) {
+        continue;
+      }
+      sel[f] = bs_calloc(n_slots, sizeof(bool));
+      if (comp) {
+        cmps[f] = bs_calloc(n_slots, sizeof(dcmp_t *));
+      } else {
+        files[f] = bs_calloc(n_slots, sizeof(FILE *));
+        idxs[f] = bs_calloc(n_slots, sizeof(didx_t *));
+      }
+      if (mux) {
+        sprintf(filename,"%s.%s.csv", mux_prefix, dfmt_file_name[f]);
+        if (!dflt_stream_selected(dfmt_file_stream(f))) {
+          continue;
+        } else if (!comp) {
+          pending[f] = true;
+          sel[f][0] = true;
+        } else if (access(filename, F_OK) == 0) {
+          cmps[f][0] = dcmp_open_csv(filename, dfmt_file_name[f], -1, stop_on_diff);
+          sel[f][0] = (cmps[f][0] != NULL);
+        } else {
+          bs_trace_warning_line("%s does not exist => won't be checked\n", filename);
+        }
+        continue;
+      }
+      for (int i = 0; i < n_dev; i++) {
+        if (!dflt_selected(i, dfmt_file_stream(f))) {
+          continue;
+        }
+        sprintf(filename,"%s/d_%s_%02i.%s.csv", path, p, i, dfmt_file_name[f]);
+        if (comp) {
+          cmps[f][i] = dcmp_open_csv(filename, dfmt_file_name[f], i, stop_on_diff);
+          sel[f][i] = (cmps[f][i] != NULL);
+        } else {
+          files[f][i] = open_file(filename);
+          fputs(dfmt_heading[f], files[f][i]);
+          idxs[f][i] = open_idx(filename);
+          sel[f][i] = true;
+        }
       }
-      dump_txv1_heading(txv1_f[i]);
-      dump_rxv1_heading(rxv1_f[i]);
-      dump_txv2_heading(txv2_f[i]);
-      dump_rxv2_heading(rxv2_f[i]);
-      dump_RSSI_heading(RSSI_f[i]);
-      dump_CCA_heading(CCA_f[i]);
-      dump_modemrx_heading(modemrx_f[i]);
     }
   }
 
   free(path);
-}
 
-static int print_stats(const char* type, int i, uint32_t n_op, uint32_t n_err, FILE *f) {
-  int tracel;
+  /*
+   * With dump_imm the records are written right away by the simulation
+   * thread, so nothing is lost if the Phy or a device crashes or hangs
+   */
+  if (!comp && !dump_imm) {
+    dwr_start(dump_record_sink, DUMP_RING_SIZE);
+  }
+}
 
-  if (n_op > 0) {
-    if (n_err == 0) {
-      tracel = 4;
-    } else {
-      tracel = 1;
+static void close_files(FILE ***f_array) {
+  if (*f_array == NULL) {
+    return;
+  }
+  for (int i = 0; i < n_slots; i ++) {
+    if ((*f_array)[i] != NULL) {
+      fclose((*f_array)[i]);
     }
-    bs_trace_raw(tracel, "Check: Device %2i, %s: found %i/%i differences (%.1f%%)\n",
-                 i, type, n_err, n_op, n_err*100.0/(float)n_op);
   }
-  if (f == NULL) {
-    bs_trace_raw(1, "Check: Device %2i, %s: comparison stopped before end of simulation\n",
-                 i, type);
+  free(*f_array);
+  *f_array = NULL;
+}
+
+static void close_idxs(didx_t ***x_array) {
+  if (*x_array == NULL) {
+    return;
+  }
+  for (int i = 0; i < n_slots; i ++) {
+    didx_close((*x_array)[i]);
   }
-  return (n_err!=0);
+  free(*x_array);
+  *x_array = NULL;
+}
+
+static int close_cmps(dcmp_t ***c_array) {
+  int ret_error = 0;
+
+  if (*c_array == NULL) {
+    return 0;
+  }
+  for (int i = 0; i < n_slots; i ++) {
+    ret_error |= dcmp_close((*c_array)[i]);
+  }
+  free(*c_array);
+  *c_array = NULL;
+  return ret_error;
 }
 
 int close_dump_files() {
-  int i;
   int ret_error = 0;
 
-  if (stats != NULL) {
+  dumping = false;
+  dwr_stop();
+
+  if (digest_file != NULL) {
     if (comp) {
-      for ( i = 0 ; i < n_dev; i ++) {
-        ret_error |= print_stats("Tx", i, stats[i].nbr_txv1, stats[i].nbr_txv1_er, txv1_f[i]);
-        ret_error |= print_stats("Rx", i, stats[i].nbr_rxv1, stats[i].nbr_rxv1_er, rxv1_f[i]);
-        ret_error |= print_stats("Txv2", i, stats[i].nbr_txv2, stats[i].nbr_txv2_er, txv2_f[i]);
-        ret_error |= print_stats("Rxv2", i, stats[i].nbr_rxv2, stats[i].nbr_rxv2_er, rxv2_f[i]);
-        ret_error |= print_stats("RSSI", i, stats[i].nbr_RSSI, stats[i].nbr_RSSI_er, RSSI_f[i]);
-        ret_error |= print_stats("CCA" , i, stats[i].nbr_CCA,  stats[i].nbr_CCA_er, CCA_f[i]);
-        ret_error |= print_stats("ModemRx", i, stats[i].nbr_modemrx, stats[i].nbr_modemrx_er, modemrx_f[i]);
-      }
-    }
-    free(stats);
-    stats = NULL;
-  }
-
-  if ((txv1_f != NULL) && (rxv1_f != NULL) &&
-      (txv2_f != NULL) && (rxv2_f != NULL) &&
-      (RSSI_f != NULL) && (modemrx_f != NULL) &&
-      (CCA_f != NULL) ) {
-    for (i = 0; i < n_dev; i ++) {
-      if (txv1_f[i] != NULL)
-        fclose(txv1_f[i]);
-      if (rxv1_f[i] != NULL)
-        fclose(rxv1_f[i]);
-      if (txv2_f[i] != NULL)
-        fclose(txv2_f[i]);
-      if (rxv2_f[i] != NULL)
-        fclose(rxv2_f[i]);
-      if (RSSI_f[i] != NULL)
-        fclose(RSSI_f[i]);
-      if (CCA_f[i] != NULL)
-        fclose(CCA_f[i]);
-      if (modemrx_f[i] != NULL)
-        fclose(modemrx_f[i]);
+      ret_error |= ddig_compare_manifest(digest_file);
+    } else {
+      ddig_write_manifest(digest_file);
     }
-    free(txv1_f);
-    free(rxv1_f);
-    free(txv2_f);
-    free(rxv2_f);
-    free(RSSI_f);
-    free(CCA_f);
-    free(modemrx_f);
-    txv1_f = NULL;
-    rxv1_f = NULL;
-    txv2_f = NULL;
-    rxv2_f = NULL;
-    RSSI_f = NULL;
-    CCA_f = NULL;
-    modemrx_f = NULL;
-  }
+    ddig_free();
+    free(digest_file);
+    digest_file = NULL;
+  }
+
+  for (int f = 0; f < P2G4_DF_N; f++) {
+    close_files(&files[f]);
+    close_idxs(&idxs[f]);
+    ret_error |= close_cmps(&cmps[f]);
+    free(sel[f]);
+    sel[f] = NULL;
+  }
+  for (int st = 0; st < P2G4_DS_N; st++) {
+    close_files(&bin_files[st]);
+    close_idxs(&bin_idxs[st]);
+    ret_error |= close_cmps(&bin_cmps[st]);
+    free(bin_sel[st]);
+    bin_sel[st] = NULL;
+  }
+  free(line);
+  line = NULL;
+  line_size = 0;
+  free(modemrx_txs);
+  modemrx_txs = NULL;
+  free(mux_prefix);
+  mux_prefix = NULL;
+  dflt_free();
+  memset(pending, 0, sizeof(pending));
+  memset(bin_pending, 0, sizeof(bin_pending));
 
   return ret_error;
 }
 
-void print_or_compare(FILE** file, char *produced, size_t str_size, uint dev_nbr,
-                      const char* type, uint32_t *err_count, uint32_t op_nbr) {
-
-  if ( comp == 0 ) {
-    fprintf(*file,"%s\n",produced);
-    return;
-  }
-
-  int result ;
-  char file_content[str_size];
+/**
+ * Index in the files arrays for device <d>
+ */
+static inline uint slot(uint d) {
+  return mux ? 0 : d;
+}
 
-  bs_readline(file_content, str_size, *file);
-  result = compare(produced, file_content,str_size);
-  if (result == 0)
-    return;
+static bool file_wanted(p2G4_dump_file_t f, uint d) {
+  return (sel[f] != NULL) && sel[f][slot(d)];
+}
 
-  char cursor[-result+1];
-  if (file_content[0] == 0) {
-    strcpy(file_content,"<eof>[End of file reached]");
-    fclose(*file);
-    *file = NULL;
+/**
+ * Is any file open for dumping (or comparing) this stream for this device
+ */
+static bool stream_wanted(p2G4_dump_stream_t stream, uint d) {
+  if (!dumping || !dflt_selected(d, stream)) {
+    return false;
   }
-  *err_count +=1;
-  bs_trace_raw(1,"Comp: Device %i, %s %i differs\n", dev_nbr, type, op_nbr);
-  bs_trace_raw(2,"Comp: Read:\"%s\"\n", file_content);
-  bs_trace_raw(2,"Comp:      \"%s\"\n", produced);
-  generate_cursor(cursor, -result);
-  bs_trace_raw(2,"Comp:       %s\n", cursor);
-
-  if (stop_on_diff) {
-    bs_trace_error("Simulation terminated due to differences in kill mode\n");
+  if (digest) {
+    return true;
   }
-
-  if (*err_count > MAX_ERRORS) {
-    fclose(*file);
-    *file = NULL;
-    bs_trace_warning_line("Too many errors in %s file for device %i. It won't be checked anymore\n", type, dev_nbr);
+  if (binary) {
+    return (bin_sel[stream] != NULL) && bin_sel[stream][slot(d)];
   }
-}
-
-void dump_txv1(tx_el_t *tx, uint dev_nbr) {
-  if ( ( txv1_f == NULL ) || ( txv1_f[dev_nbr] == NULL ) ){
-    return;
+  for (int i = 0; i < 2; i++) {
+    int f = stream_files[stream][i];
+    if ((f >= 0) && file_wanted(f, d)) {
+      return true;
+    }
   }
+  return false;
+}
 
-  stats[dev_nbr].nbr_txv1++;
-
-  size_t size = 1024 + tx->tx_s.packet_size*3+1;
-  p2G4_txv2_t *txs = &tx->tx_s;
-  char to_print[size];
-  int printed;
-  printed = snprintf(to_print, 1024,
-                    "%"PRItime",%"PRItime","
-                    "%.6f,"
-                    "0x%08X,%u,"
-                    "%.6f,"
-                    "%"PRItime",%"PRItime","
-                    "%u,",
-                    txs->start_tx_time, txs->end_tx_time,
-                    p2G4_freq_to_d(txs->radio_params.center_freq),
-                    (uint32_t)txs->phy_address, txs->radio_params.modulation,
-                    p2G4_power_to_d(txs->power_level),
-                    txs->abort.abort_time, txs->abort.recheck_time,
-                    txs->packet_size);
-
-  if ( tx->tx_s.packet_size > 0 ) {
-    char packetstr[tx->tx_s.packet_size*3+1];
-    bs_hex_dump(packetstr, tx->packet, tx->tx_s.packet_size);
-    sprintf(&to_print[printed],"%s",packetstr);
-  }
-
-  print_or_compare(&txv1_f[dev_nbr],
-                   to_print, size, dev_nbr, "Tx",
-                   &stats[dev_nbr].nbr_txv1_er,
-                   stats[dev_nbr].nbr_txv1);
+/**
+ * Create the multiplexed files on their first record
+ */
+static FILE *get_file(p2G4_dump_file_t f, uint d) {
+  if (pending[f]) {
+    char filename[strlen(mux_prefix) + 16];
+    sprintf(filename, "%s.%s.csv", mux_prefix, dfmt_file_name[f]);
+    files[f][0] = open_file(filename);
+    fprintf(files[f][0], "dev,%s", dfmt_heading[f]);
+    idxs[f][0] = open_idx(filename);
+    pending[f] = false;
+  }
+  return files[f][slot(d)];
 }
 
-void dump_txv2(tx_el_t *tx, uint dev_nbr) {
-  if ( ( txv2_f == NULL ) || ( txv2_f[dev_nbr] == NULL ) ){
-    return;
+static FILE *get_bin_file(p2G4_dump_stream_t stream, uint d) {
+  if (bin_pending[stream]) {
+    char filename[strlen(mux_prefix) + 16];
+    sprintf(filename, "%s.%s.bin", mux_prefix, dbin_stream_name[stream]);
+    bin_files[stream][0] = open_bin_file(filename, stream, P2G4_DBIN_ALL_DEVS);
+    bin_idxs[stream][0] = open_idx(filename);
+    bin_pending[stream] = false;
   }
-
-  stats[dev_nbr].nbr_txv2++;
-
-  size_t size = 1024 + tx->tx_s.packet_size*3+1;
-  p2G4_txv2_t *txs = &tx->tx_s;
-  char to_print[size];
-  int printed;
-  printed = snprintf(to_print, 1024,
-                    "%"PRItime",%"PRItime","
-                    "%"PRItime",%"PRItime","
-                    "%.6f,"
-                    "0x%08X,%u,"
-                    "%u,"
-                    "%.6f,"
-                    "%"PRItime",%"PRItime","
-                    "%u,",
-                    txs->start_tx_time, txs->end_tx_time,
-                    txs->start_packet_time, txs->end_packet_time,
-                    p2G4_freq_to_d(txs->radio_params.center_freq),
-                    (uint32_t)txs->phy_address, txs->radio_params.modulation,
-                    txs->coding_rate,
-                    p2G4_power_to_d(txs->power_level),
-                    txs->abort.abort_time, txs->abort.recheck_time,
-                    txs->packet_size);
-
-  if ( tx->tx_s.packet_size > 0 ) {
-    char packetstr[tx->tx_s.packet_size*3+1];
-    bs_hex_dump(packetstr, tx->packet, tx->tx_s.packet_size);
-    sprintf(&to_print[printed],"%s",packetstr);
-  }
-
-  print_or_compare(&txv2_f[dev_nbr],
-                   to_print, size, dev_nbr, "Tx",
-                   &stats[dev_nbr].nbr_txv2_er,
-                   stats[dev_nbr].nbr_txv2);
+  return bin_files[stream][slot(d)];
 }
 
+/**
+ * Format a record as a line of the CSV file type <f> into <line>
+ * (prefixed with the device number in multiplexed files)
+ * Returns the line length
+ */
+static int format_line(p2G4_dump_file_t f, const p2G4_drec_hdr_t *rec, const void *var,
+                       const char *hex) {
+  int pre, len;
+
+  if (line_size == 0) {
+    line_size = 1024;
+    line = bs_malloc(line_size);
+  }
+  do {
+    pre = mux ? snprintf(line, line_size, "%u,", rec->dev) : 0;
+    len = pre + dfmt_record(&line[pre], line_size - pre, f, rec, var, hex);
+    if ((size_t)len < line_size) {
+      break;
+    }
+    line_size = 2*len + 1024;
+    line = bs_realloc(line, line_size);
+  } while (true);
 
-void dump_tx(tx_el_t *tx, uint dev_nbr){
-  dump_txv1(tx, dev_nbr);
-  dump_txv2(tx, dev_nbr);
+  return len;
 }
 
-void dump_rxv1(rx_status_t *rx_st, uint8_t* packet, uint dev_nbr){
-  if ( ( rxv1_f == NULL ) || ( rxv1_f[dev_nbr] == NULL ) ) {
+/**
+ * Dump (or compare) a record of <stream> for device <d> in all files it goes to
+ * <var> is the record variable part, and <packet> (if not NULL) the packet
+ * it comes from (to reuse its hex representation)
+ */
+static void dump_record(p2G4_dump_stream_t stream, uint d, const p2G4_drec_hdr_t *rec,
+                        const void *var, p2G4_packet_t *packet) {
+  const char *hex = NULL;
+
+  if (digest) {
+    ddig_record(stream, rec, var);
     return;
   }
 
-  stats[dev_nbr].nbr_rxv1++;
-
-  const uint dbufsi = 2048;
-  size_t size = dbufsi + rx_st->rx_done_s.packet_size*3;
-
-  char to_print[ size + 1];
-  p2G4_rxv2_t *req = &rx_st->rx_s;
-  p2G4_rxv2_done_t *resp = &rx_st->rx_done_s;
-  int printed;
-
-  printed = snprintf(to_print, dbufsi,
-                    "%"PRItime",%u,"
-                    "0x%08X,%u,"
-                    "%.6f,"
-                    "%.6f,"
-                    "%u,%u,"
-                    "%u,"
-                    "%u,%u,%"PRItime",%"PRItime","
-                    "%i,%u,%"PRItime",%"PRItime","
-                    "%"PRItime",%"PRItime",%u,"
-                    "%.6f,"
-                    "%u,",
-                    req->start_time, req->scan_duration,
-                    (uint32_t)rx_st->phy_address[0], req->radio_params.modulation,
-                    p2G4_freq_to_d(req->radio_params.center_freq),
-                    p2G4_power_to_d(req->antenna_gain),
-                    req->sync_threshold, req->header_threshold,
-                    req->pream_and_addr_duration,
-                    req->header_duration, req->error_calc_rate, req->abort.abort_time, req->abort.recheck_time,
-
-                    rx_st->tx_nbr,
-                    rx_st->biterrors,
-                    rx_st->sync_end,
-                    rx_st->header_end,
-
-                    rx_st->payload_end,
-                    resp->rx_time_stamp,
-                    resp->status,
-                    p2G4_RSSI_value_to_dBm(resp->rssi.RSSI),
-
-                    resp->packet_size);
-
-  if ( ( resp->packet_size > 0 ) && ( packet != NULL ) ) {
-    char packetstr[resp->packet_size*3+1];
-    bs_hex_dump(packetstr, packet, resp->packet_size);
-    sprintf(&to_print[printed],"%s",packetstr);
-  }
-
-  print_or_compare(&rxv1_f[dev_nbr],
-                   to_print, size, dev_nbr, "Rx",
-                   &stats[dev_nbr].nbr_rxv1_er,
-                   stats[dev_nbr].nbr_rxv1);
-}
-
-void dump_rxv2(rx_status_t *rx_st, uint8_t* packet, uint dev_nbr){
-  if ( ( rxv2_f == NULL ) || ( rxv2_f[dev_nbr] == NULL ) ) {
+  if (binary) {
+    if (comp) {
+      dcmp_bin(bin_cmps[stream][slot(d)], rec, var);
+      return;
+    }
+    FILE *file = get_bin_file(stream, d);
+    if (bin_idxs[stream][slot(d)] != NULL) {
+      didx_record(bin_idxs[stream][slot(d)], rec->time, file);
+    }
+    dbin_write(file, stream, rec, var);
+    if (dump_imm) {
+      fflush(file);
+    }
     return;
   }
 
-  stats[dev_nbr].nbr_rxv2++;
+  if ((packet != NULL) && (rec->var_size > 0) && (rec->var_size == packet->size)) {
+    hex = p2G4_packet_hex(packet);
+  }
 
-  const uint dbufsi = 2048; //The print below adds to 623 + commas, + a lot of margin for careless expansion
-  size_t size = dbufsi + rx_st->rx_done_s.packet_size*3;
+  for (int i = 0; i < 2; i++) {
+    int f = stream_files[stream][i];
+    if ((f < 0) || !file_wanted(f, d)) {
+      continue;
+    }
+    int len = format_line(f, rec, var, hex);
 
-  char to_print[ size + 1];
-  p2G4_rxv2_t *req = &rx_st->rx_s;
-  p2G4_rxv2_done_t *resp = &rx_st->rx_done_s;
-  int printed;
-
-  printed = snprintf(to_print, dbufsi,
-                    "%"PRItime",%u," //20chars + 10chars
-                    "%u,\"[",        //3 + (4+16*18)
-                    req->start_time, req->scan_duration,
-                    req->n_addr);
-
-  for (int i = 0 ; i < req->n_addr ; i++) {
-    printed += snprintf(&to_print[printed], dbufsi - printed,
-        "0x%08"PRIx64, (uint64_t)rx_st->phy_address[i]);
-    if (i < (int)req->n_addr - 1) {
-      printed += snprintf(&to_print[printed], dbufsi - printed,
-              ",");
+    if (comp) {
+      dcmp_csv(cmps[f][slot(d)], line, len);
+    } else {
+      FILE *file = get_file(f, d);
+      if (idxs[f][slot(d)] != NULL) {
+        didx_record(idxs[f][slot(d)], rec->time, file);
+      }
+      fwrite(line, len, 1, file);
+      fputc('\n', file);
     }
   }
-
-  printed += snprintf(&to_print[printed], dbufsi - printed,
-                    "]\", %u," //+4
-                    "%.6f,"    //10
-                    "%.6f,"    //10
-
-                    "%u,"      //10
-                    "%u,%u,"   //10+10
-                    "%u,"      //10
-                    "%u,%u,"   //10+10
-
-                    "%u,"      //10
-                    "%u,"      //10
-                    "%u,"      //3"
-
-                    "%u,"      //3
-                    "%"PRItime",%"PRItime"," //20+20
-
-                    "%i,"      //10
-                    "0x%08"PRIx64"," //16
-                    "%u,"      //10
-                    "%u,"      //10
-                    "%"PRItime"," //20
-                    "%"PRItime"," //20
-
-                    "%"PRItime"," //20
-                    "%"PRItime"," //20
-                    "%u,"         //3
-                    "%.6f,"       //10
-
-                    "%u,",        //10
-                    req->radio_params.modulation,
-                    p2G4_freq_to_d(req->radio_params.center_freq),
-                    p2G4_power_to_d(req->antenna_gain),
-
-                    req->acceptable_pre_truncation,
-                    req->sync_threshold, req->header_threshold,
-                    req->pream_and_addr_duration,
-                    req->header_duration, req->error_calc_rate,
-
-                    req->forced_packet_duration,
-                    req->coding_rate,
-                    req->prelocked_tx,
-
-                    req->resp_type,
-                    req->abort.abort_time, req->abort.recheck_time,
-
-                    rx_st->tx_nbr,
-                    resp->phy_address,
-                    resp->coding_rate,
-                    rx_st->biterrors,
-                    rx_st->sync_end,
-                    rx_st->header_end,
-
-                    rx_st->payload_end,
-                    resp->rx_time_stamp,
-                    resp->status,
-                    p2G4_RSSI_value_to_dBm(resp->rssi.RSSI),
-
-                    resp->packet_size);
-
-  if ( ( resp->packet_size > 0 ) && ( packet != NULL ) ) {
-    char packetstr[resp->packet_size*3+1];
-    bs_hex_dump(packetstr, packet, resp->packet_size);
-    sprintf(&to_print[printed],"%s",packetstr);
-  }
-
-  print_or_compare(&rxv2_f[dev_nbr],
-                   to_print, size, dev_nbr, "Rxv2",
-                   &stats[dev_nbr].nbr_rxv2_er,
-                   stats[dev_nbr].nbr_rxv2);
 }
 
-void dump_rx(rx_status_t *rx_st, uint8_t* packet, uint dev_nbr) {
-  dump_rxv1(rx_st, packet, dev_nbr);
-  dump_rxv2(rx_st, packet, dev_nbr);
+/*
+ * (In the writer thread) The packets the records came from may have been
+ * released or reused already, so their cached hex representation cannot be
+ * used here, and the packets are converted again. But this is done outside
+ * of the simulation thread.
+ */
+static void dump_record_sink(p2G4_dump_stream_t stream, const p2G4_drec_hdr_t *rec,
+                             const void *var) {
+  dump_record(stream, rec->dev, rec, var, NULL);
 }
 
-void dump_RSSImeas(p2G4_rssi_t *RSSI_req, p2G4_rssi_done_t* RSSI_res, uint dev_nbr){
-  if ( ( RSSI_f == NULL ) || ( RSSI_f[dev_nbr] == NULL ) ){
-    return;
+/**
+ * Dump a record, either thru the writer thread, or directly
+ */
+static void emit_record(p2G4_dump_stream_t stream, const p2G4_drec_hdr_t *rec, size_t rec_size,
+                        const void *var, p2G4_packet_t *packet) {
+  if (dwr_running()) {
+    dwr_push(stream, rec, rec_size, var);
+  } else {
+    dump_record(stream, rec->dev, rec, var, packet);
   }
-
-  stats[dev_nbr].nbr_RSSI++;
-
-  size_t size = 512; //size below adds to a max of 53 chars + commas + a lot of margin for careless expansion
-  char to_print[size +1];
-
-  snprintf(to_print, size,
-      "%"PRItime"," //20 chars
-      "%u,%.6f,"    //3+10
-      "%.6f,"       //10
-      "%.6f",       //10
-      RSSI_req->meas_time,
-      RSSI_req->radio_params.modulation,
-      p2G4_freq_to_d(RSSI_req->radio_params.center_freq),
-      p2G4_power_to_d(RSSI_req->antenna_gain),
-      p2G4_RSSI_value_to_dBm(RSSI_res->RSSI));
-
-  print_or_compare(&RSSI_f[dev_nbr],
-                   to_print, size, dev_nbr, "RSSI",
-                   &stats[dev_nbr].nbr_RSSI_er,
-                   stats[dev_nbr].nbr_RSSI);
 }
 
+void dump_tx(tx_el_t *tx, p2G4_packet_t *packet, uint dev_nbr){
+  p2G4_drec_tx_t rec;
+  p2G4_txv2_t *txs = &tx->tx_s;
 
-void dump_cca(cca_status_t *cca, uint dev_nbr) {
-  if ( ( CCA_f == NULL ) || ( CCA_f[dev_nbr] == NULL ) ){
+  if (!stream_wanted(P2G4_DS_TX, dev_nbr)
+      || !dflt_pass(txs->start_tx_time, txs->radio_params.center_freq)
+      || !dflt_addr_pass(&txs->phy_address, 1)) {
     return;
   }
 
-  stats[dev_nbr].nbr_CCA++;
-
-  size_t size = 512; //size below adds to a max of 180chars + commas + a lot of margin for careless expansion
-  char to_print[size +1];
-
-  snprintf(to_print, size,
-      "%"PRItime"," //20
-      "%u," //10
-      "%u," //10
-
-      "%u," //3
-      "%.6f," //10
-      "%.6f," //10
-
-      "%.6f," //10
-      "%.6f," //10
-      "%u,"   //3
+  memset(&rec, 0, sizeof(rec));
+  rec.h.time = txs->start_tx_time;
+  rec.h.dev = dev_nbr;
+  rec.h.var_size = (packet != NULL) ? txs->packet_size : 0;
+  rec.start_tx_time = txs->start_tx_time;
+  rec.end_tx_time = txs->end_tx_time;
+  rec.start_packet_time = txs->start_packet_time;
+  rec.end_packet_time = txs->end_packet_time;
+  rec.phy_address = txs->phy_address;
+  rec.abort_time = txs->abort.abort_time;
+  rec.recheck_time = txs->abort.recheck_time;
+  rec.center_freq = txs->radio_params.center_freq;
+  rec.modulation = txs->radio_params.modulation;
+  rec.power_level = txs->power_level;
+  rec.coding_rate = txs->coding_rate;
+  rec.packet_size = txs->packet_size;
+
+  emit_record(P2G4_DS_TX, &rec.h, sizeof(rec), packet ? packet->data : NULL, packet);
+}
 
-      "%"PRItime",%"PRItime"," //20+20
+void dump_rx(rx_status_t *rx_st, p2G4_packet_t *packet, uint dev_nbr) {
+  p2G4_drec_rx_t rec;
+  p2G4_rxv2_t *req = &rx_st->rx_s;
+  p2G4_rxv2_done_t *resp = &rx_st->rx_done_s;
 
-      "%"PRItime"," //20
-      "%.6f," //10
-      "%.6f," //10
-      "%.6f," //10
-      "%u,%u" //2+2
-      ,
+  if (!stream_wanted(P2G4_DS_RX, dev_nbr)
+      || !dflt_pass(req->start_time, req->radio_params.center_freq)
+      || !dflt_addr_pass(rx_st->phy_address, BS_MIN(req->n_addr, P2G4_RXV2_MAX_ADDRESSES))) {
+    return;
+  }
 
-      cca->req.start_time,
-      cca->req.scan_duration,
-      cca->req.scan_period,
+  memset(&rec, 0, sizeof(rec));
+  rec.h.time = req->start_time;
+  rec.h.dev = dev_nbr;
+  if ((resp->packet_size > 0) && (packet != NULL)) {
+    rec.h.var_size = BS_MIN(resp->packet_size, packet->size);
+  }
+  rec.start_time = req->start_time;
+  rec.abort_time = req->abort.abort_time;
+  rec.recheck_time = req->abort.recheck_time;
+  rec.sync_end = rx_st->sync_end;
+  rec.header_end = rx_st->header_end;
+  rec.payload_end = rx_st->payload_end;
+  rec.rx_time_stamp = resp->rx_time_stamp;
+  rec.matched_address = resp->phy_address;
+  for (int i = 0; i < BS_MIN(req->n_addr, P2G4_RXV2_MAX_ADDRESSES); i++) {
+    rec.phy_address[i] = rx_st->phy_address[i];
+  }
+  rec.scan_duration = req->scan_duration;
+  rec.error_calc_rate = req->error_calc_rate;
+  rec.forced_packet_duration = req->forced_packet_duration;
+  rec.tx_nbr = rx_st->tx_nbr;
+  rec.biterrors = rx_st->biterrors;
+  rec.rssi = resp->rssi.RSSI;
+  rec.modulation = req->radio_params.modulation;
+  rec.center_freq = req->radio_params.center_freq;
+  rec.antenna_gain = req->antenna_gain;
+  rec.acceptable_pre_truncation = req->acceptable_pre_truncation;
+  rec.sync_threshold = req->sync_threshold;
+  rec.header_threshold = req->header_threshold;
+  rec.pream_and_addr_duration = req->pream_and_addr_duration;
+  rec.header_duration = req->header_duration;
+  rec.coding_rate = req->coding_rate;
+  rec.tx_coding_rate = resp->coding_rate;
+  rec.packet_size = resp->packet_size;
+  rec.n_addr = req->n_addr;
+  rec.prelocked_tx = req->prelocked_tx;
+  rec.resp_type = req->resp_type;
+  rec.status = resp->status;
+
+  emit_record(P2G4_DS_RX, &rec.h, sizeof(rec), packet ? packet->data : NULL, packet);
+}
 
-      cca->req.radio_params.modulation,
-      p2G4_freq_to_d(cca->req.radio_params.center_freq),
-      p2G4_power_to_d(cca->req.antenna_gain),
+void dump_RSSImeas(p2G4_rssi_t *RSSI_req, p2G4_rssi_done_t* RSSI_res, uint dev_nbr){
+  p2G4_drec_rssi_t rec;
 
-      p2G4_RSSI_value_to_dBm(cca->req.mod_threshold),
-      p2G4_RSSI_value_to_dBm(cca->req.rssi_threshold),
-      cca->req.stop_when_found,
+  if (!stream_wanted(P2G4_DS_RSSI, dev_nbr)
+      || !dflt_pass(RSSI_req->meas_time, RSSI_req->radio_params.center_freq)) {
+    return;
+  }
 
-      cca->req.abort.abort_time, cca->req.abort.recheck_time,
+  memset(&rec, 0, sizeof(rec));
+  rec.h.time = RSSI_req->meas_time;
+  rec.h.dev = dev_nbr;
+  rec.meas_time = RSSI_req->meas_time;
+  rec.rssi = RSSI_res->RSSI;
+  rec.modulation = RSSI_req->radio_params.modulation;
+  rec.center_freq = RSSI_req->radio_params.center_freq;
+  rec.antenna_gain = RSSI_req->antenna_gain;
 
-      cca->resp.end_time,
-      p2G4_RSSI_value_to_dBm(cca->resp.RSSI_ave),
-      p2G4_RSSI_value_to_dBm(cca->resp.RSSI_max),
-      p2G4_RSSI_value_to_dBm(cca->resp.mod_rx_power),
-      cca->resp.mod_found, cca->resp.rssi_overthreshold
-      );
+  emit_record(P2G4_DS_RSSI, &rec.h, sizeof(rec), NULL, NULL);
+}
 
+void dump_cca(cca_status_t *cca, uint dev_nbr) {
+  p2G4_drec_cca_t rec;
 
+  if (!stream_wanted(P2G4_DS_CCA, dev_nbr)
+      || !dflt_pass(cca->req.start_time, cca->req.radio_params.center_freq)) {
+    return;
+  }
 
-  print_or_compare(&CCA_f[dev_nbr],
-                   to_print, size, dev_nbr, "CCA",
-                   &stats[dev_nbr].nbr_CCA_er,
-                   stats[dev_nbr].nbr_CCA);
+  memset(&rec, 0, sizeof(rec));
+  rec.h.time = cca->req.start_time;
+  rec.h.dev = dev_nbr;
+  rec.start_time = cca->req.start_time;
+  rec.abort_time = cca->req.abort.abort_time;
+  rec.recheck_time = cca->req.abort.recheck_time;
+  rec.end_time = cca->resp.end_time;
+  rec.scan_duration = cca->req.scan_duration;
+  rec.scan_period = cca->req.scan_period;
+  rec.mod_threshold = cca->req.mod_threshold;
+  rec.rssi_threshold = cca->req.rssi_threshold;
+  rec.RSSI_ave = cca->resp.RSSI_ave;
+  rec.RSSI_max = cca->resp.RSSI_max;
+  rec.mod_rx_power = cca->resp.mod_rx_power;
+  rec.modulation = cca->req.radio_params.modulation;
+  rec.center_freq = cca->req.radio_params.center_freq;
+  rec.antenna_gain = cca->req.antenna_gain;
+  rec.stop_when_found = cca->req.stop_when_found;
+  rec.mod_found = cca->resp.mod_found;
+  rec.rssi_overthreshold = cca->resp.rssi_overthreshold;
+
+  emit_record(P2G4_DS_CCA, &rec.h, sizeof(rec), NULL, NULL);
 }
 
 void dump_ModemRx(bs_time_t CurrentTime, uint tx_nbr, uint dev_nbr, uint ndev, uint CalNotRecal, p2G4_modemdigparams_t *modem_p, rec_status_t *rx_st, tx_l_c_t *tx_l ){
-  if ( ( modemrx_f == NULL ) || ( modemrx_f[dev_nbr] == NULL ) ) {
+  p2G4_drec_modemrx_t rec;
+
+  if (!stream_wanted(P2G4_DS_MODEMRX, dev_nbr)
+      || !dflt_pass(CurrentTime, modem_p->center_freq)) {
     return;
   }
 
-  stats[dev_nbr].nbr_modemrx++;
-
-#define _ModemRxStrSize 4096
-  size_t size = _ModemRxStrSize;
-  char to_print[_ModemRxStrSize +1];
-
-  uint printed = snprintf(to_print, _ModemRxStrSize,
-                          "%"PRItime",%u,"
-                          "%u,%f,%u,"
-                          "%u,"
-                          "%e,%e,"
-                          "%f,%f,%f",
-                          CurrentTime,
-                          tx_nbr,
-
-                          CalNotRecal,
-                          p2G4_freq_to_d(modem_p->center_freq),
-                          modem_p->modulation,
-
-                          modem_p->coding_rate,
-
-                          rx_st->BER/(double)RAND_PROB_1,
-                          rx_st->sync_prob/(double)RAND_PROB_1,
-
-                          rx_st->SNR_total,
-                          rx_st->SNR_analog_o,
-                          rx_st->SNR_ISI);
-
-  for ( uint tx = 0 ; tx< ndev; tx++){
-    if ( tx_l->used[tx] ){
-      printed += snprintf(&to_print[printed], _ModemRxStrSize-printed, ",%f,%f", rx_st->att[tx], rx_st->rx_pow[tx]);
-    } else {
-      printed += snprintf(&to_print[printed], _ModemRxStrSize-printed, ",NaN, NaN");
-    }
-    if (printed >= _ModemRxStrSize){
-      bs_trace_warning_line("Too many devices, ModemRx dumping disabled\n");
-      fclose(modemrx_f[dev_nbr]);
-      modemrx_f[dev_nbr] = NULL;
+  memset(&rec, 0, sizeof(rec));
+  rec.h.time = CurrentTime;
+  rec.h.dev = dev_nbr;
+  rec.time = CurrentTime;
+  rec.SNR_total = rx_st->SNR_total;
+  rec.SNR_analog_o = rx_st->SNR_analog_o;
+  rec.SNR_ISI = rx_st->SNR_ISI;
+  rec.tx_nbr = tx_nbr;
+  rec.CalNotRecal = CalNotRecal;
+  rec.BER = rx_st->BER;
+  rec.sync_prob = rx_st->sync_prob;
+  rec.n_devs = ndev;
+  rec.center_freq = modem_p->center_freq;
+  rec.modulation = modem_p->modulation;
+  rec.coding_rate = modem_p->coding_rate;
+
+  for (uint tx = 0; tx < ndev; tx++) {
+    if (tx_l->used[tx]) {
+      memset(&modemrx_txs[rec.n_tx], 0, sizeof(p2G4_drec_modemrx_tx_t));
+      modemrx_txs[rec.n_tx].tx = tx;
+      modemrx_txs[rec.n_tx].att = rx_st->att[tx];
+      modemrx_txs[rec.n_tx].rx_pow = rx_st->rx_pow[tx];
+      rec.n_tx++;
     }
   }
+  rec.h.var_size = rec.n_tx * sizeof(p2G4_drec_modemrx_tx_t);
 
-  print_or_compare(&modemrx_f[dev_nbr],
-                   to_print, size, dev_nbr, "ModemRx",
-                   &stats[dev_nbr].nbr_modemrx_er,
-                   stats[dev_nbr].nbr_modemrx);
+  emit_record(P2G4_DS_MODEMRX, &rec.h, sizeof(rec), modemrx_txs, NULL);
 }
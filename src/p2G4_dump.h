@@ -21,16 +21,33 @@
 #include "bs_pc_2G4_types.h"
 #include "p2G4_channel_and_modem_priv.h"
 #include "p2G4_pending_tx_rx_list.h"
+#include "p2G4_dump_filter.h"
 
 #ifdef __cplusplus
 extern "C"{
 #endif
 
+typedef struct {
+  bool compare;      /* Compare instead of dumping */
+  bool stop_on_diff; /* Stop the simulation at the first difference */
+  bool dump_imm;     /* Do not buffer more than a line/record */
+  bool binary;       /* Binary dump files (see p2G4_dump_bin.h) instead of CSV */
+  bool digest;       /* Only keep digests of what would be dumped (see p2G4_dump_digest.h) */
+  bs_time_t digest_cp; /* Digest checkpoint period */
+  bool mux;          /* One file per type for all devices (created on its first record) */
+  bool compress;     /* gzip compress the dump files */
+  bool modemrx_sparse; /* Dump ModemRx in the sparse format (only active transmitters) */
+  bs_time_t idx_period; /* Time index period (0 = no indexes, see p2G4_dump_idx.h) */
+  p2G4_dump_filter_t filter; /* What to dump */
+  const char *s_id;
+  const char *p_id;
+  uint n_devs;
+} p2G4_dump_cfg_t;
+
 /**
  * Open all dump files (as configured from command line)
  */
-void open_dump_files(uint8_t comp_i, uint8_t stop, uint8_t dump_imm, const char* s,
-                     const char* p, const uint n_dev_i);
+void open_dump_files(const p2G4_dump_cfg_t *cfg);
 
 /**
  * Close all dump files (the simulation has ended)
@@ -41,12 +58,12 @@ int close_dump_files();
  * Write to file information about a transmission
  * (v2 API)
  */
-void dump_tx(tx_el_t *tx, uint dev_nbr);
+void dump_tx(tx_el_t *tx, p2G4_packet_t *packet, uint dev_nbr);
 
 /**
  * Write to file information about a completed reception
  */
-void dump_rx(rx_status_t *rx_st, uint8_t* packet, uint d);
+void dump_rx(rx_status_t *rx_st, p2G4_packet_t *packet, uint d);
 
 /**
  * Write to file information about a completed RSSI measurement
@@ -0,0 +1,360 @@
+/*
+ * Copyright 2026 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "bs_types.h"
+#include "bs_tracing.h"
+#include "bs_oswrap.h"
+#include "bs_utils.h"
+#include "p2G4_dump_bin.h"
+
+const char *const dbin_stream_name[P2G4_DS_N] = {
+  "Txv2", "Rxv2", "RSSI", "CCA", "ModemRx"
+};
+
+const size_t dbin_rec_size[P2G4_DS_N] = {
+  sizeof(p2G4_drec_tx_t),
+  sizeof(p2G4_drec_rx_t),
+  sizeof(p2G4_drec_rssi_t),
+  sizeof(p2G4_drec_cca_t),
+  sizeof(p2G4_drec_modemrx_t)
+};
+
+#define TYPE_SIZE(type) \
+  (((type) == P2G4_DBIN_U8) ? 1 : \
+   (((type) == P2G4_DBIN_U16) || ((type) == P2G4_DBIN_I16)) ? 2 : \
+   (((type) == P2G4_DBIN_U32) || ((type) == P2G4_DBIN_I32)) ? 4 : 8)
+
+#define FIELD(rec_t, field, type) \
+  { #field, type, \
+    sizeof(((rec_t *)0)->field) / TYPE_SIZE(type), \
+    offsetof(rec_t, field), sizeof(((rec_t *)0)->field) }
+
+#define HDR_FIELDS(rec_t) \
+  FIELD(rec_t, h.time, P2G4_DBIN_U64), \
+  FIELD(rec_t, h.dev, P2G4_DBIN_U32), \
+  FIELD(rec_t, h.var_size, P2G4_DBIN_U32)
+
+static const p2G4_dbin_field_t tx_fields[] = {
+  HDR_FIELDS(p2G4_drec_tx_t),
+  FIELD(p2G4_drec_tx_t, start_tx_time, P2G4_DBIN_U64),
+  FIELD(p2G4_drec_tx_t, end_tx_time, P2G4_DBIN_U64),
+  FIELD(p2G4_drec_tx_t, start_packet_time, P2G4_DBIN_U64),
+  FIELD(p2G4_drec_tx_t, end_packet_time, P2G4_DBIN_U64),
+  FIELD(p2G4_drec_tx_t, phy_address, P2G4_DBIN_U64),
+  FIELD(p2G4_drec_tx_t, abort_time, P2G4_DBIN_U64),
+  FIELD(p2G4_drec_tx_t, recheck_time, P2G4_DBIN_U64),
+  FIELD(p2G4_drec_tx_t, center_freq, P2G4_DBIN_U16),
+  FIELD(p2G4_drec_tx_t, modulation, P2G4_DBIN_U16),
+  FIELD(p2G4_drec_tx_t, power_level, P2G4_DBIN_I16),
+  FIELD(p2G4_drec_tx_t, coding_rate, P2G4_DBIN_U16),
+  FIELD(p2G4_drec_tx_t, packet_size, P2G4_DBIN_U16),
+};
+
+static const p2G4_dbin_field_t rx_fields[] = {
+  HDR_FIELDS(p2G4_drec_rx_t),
+  FIELD(p2G4_drec_rx_t, start_time, P2G4_DBIN_U64),
+  FIELD(p2G4_drec_rx_t, abort_time, P2G4_DBIN_U64),
+  FIELD(p2G4_drec_rx_t, recheck_time, P2G4_DBIN_U64),
+  FIELD(p2G4_drec_rx_t, sync_end, P2G4_DBIN_U64),
+  FIELD(p2G4_drec_rx_t, header_end, P2G4_DBIN_U64),
+  FIELD(p2G4_drec_rx_t, payload_end, P2G4_DBIN_U64),
+  FIELD(p2G4_drec_rx_t, rx_time_stamp, P2G4_DBIN_U64),
+  FIELD(p2G4_drec_rx_t, matched_address, P2G4_DBIN_U64),
+  FIELD(p2G4_drec_rx_t, phy_address, P2G4_DBIN_U64),
+  FIELD(p2G4_drec_rx_t, scan_duration, P2G4_DBIN_U32),
+  FIELD(p2G4_drec_rx_t, error_calc_rate, P2G4_DBIN_U32),
+  FIELD(p2G4_drec_rx_t, forced_packet_duration, P2G4_DBIN_U32),
+  FIELD(p2G4_drec_rx_t, tx_nbr, P2G4_DBIN_I32),
+  FIELD(p2G4_drec_rx_t, biterrors, P2G4_DBIN_U32),
+  FIELD(p2G4_drec_rx_t, rssi, P2G4_DBIN_I32),
+  FIELD(p2G4_drec_rx_t, modulation, P2G4_DBIN_U16),
+  FIELD(p2G4_drec_rx_t, center_freq, P2G4_DBIN_U16),
+  FIELD(p2G4_drec_rx_t, antenna_gain, P2G4_DBIN_I16),
+  FIELD(p2G4_drec_rx_t, acceptable_pre_truncation, P2G4_DBIN_U16),
+  FIELD(p2G4_drec_rx_t, sync_threshold, P2G4_DBIN_U16),
+  FIELD(p2G4_drec_rx_t, header_threshold, P2G4_DBIN_U16),
+  FIELD(p2G4_drec_rx_t, pream_and_addr_duration, P2G4_DBIN_U16),
+  FIELD(p2G4_drec_rx_t, header_duration, P2G4_DBIN_U16),
+  FIELD(p2G4_drec_rx_t, coding_rate, P2G4_DBIN_U16),
+  FIELD(p2G4_drec_rx_t, tx_coding_rate, P2G4_DBIN_U16),
+  FIELD(p2G4_drec_rx_t, packet_size, P2G4_DBIN_U16),
+  FIELD(p2G4_drec_rx_t, n_addr, P2G4_DBIN_U8),
+  FIELD(p2G4_drec_rx_t, prelocked_tx, P2G4_DBIN_U8),
+  FIELD(p2G4_drec_rx_t, resp_type, P2G4_DBIN_U8),
+  FIELD(p2G4_drec_rx_t, status, P2G4_DBIN_U8),
+};
+
+static const p2G4_dbin_field_t rssi_fields[] = {
+  HDR_FIELDS(p2G4_drec_rssi_t),
+  FIELD(p2G4_drec_rssi_t, meas_time, P2G4_DBIN_U64),
+  FIELD(p2G4_drec_rssi_t, rssi, P2G4_DBIN_I32),
+  FIELD(p2G4_drec_rssi_t, modulation, P2G4_DBIN_U16),
+  FIELD(p2G4_drec_rssi_t, center_freq, P2G4_DBIN_U16),
+  FIELD(p2G4_drec_rssi_t, antenna_gain, P2G4_DBIN_I16),
+};
+
+static const p2G4_dbin_field_t cca_fields[] = {
+  HDR_FIELDS(p2G4_drec_cca_t),
+  FIELD(p2G4_drec_cca_t, start_time, P2G4_DBIN_U64),
+  FIELD(p2G4_drec_cca_t, abort_time, P2G4_DBIN_U64),
+  FIELD(p2G4_drec_cca_t, recheck_time, P2G4_DBIN_U64),
+  FIELD(p2G4_drec_cca_t, end_time, P2G4_DBIN_U64),
+  FIELD(p2G4_drec_cca_t, scan_duration, P2G4_DBIN_U32),
+  FIELD(p2G4_drec_cca_t, scan_period, P2G4_DBIN_U32),
+  FIELD(p2G4_drec_cca_t, mod_threshold, P2G4_DBIN_I32),
+  FIELD(p2G4_drec_cca_t, rssi_threshold, P2G4_DBIN_I32),
+  FIELD(p2G4_drec_cca_t, RSSI_ave, P2G4_DBIN_I32),
+  FIELD(p2G4_drec_cca_t, RSSI_max, P2G4_DBIN_I32),
+  FIELD(p2G4_drec_cca_t, mod_rx_power, P2G4_DBIN_I32),
+  FIELD(p2G4_drec_cca_t, modulation, P2G4_DBIN_U16),
+  FIELD(p2G4_drec_cca_t, center_freq, P2G4_DBIN_U16),
+  FIELD(p2G4_drec_cca_t, antenna_gain, P2G4_DBIN_I16),
+  FIELD(p2G4_drec_cca_t, stop_when_found, P2G4_DBIN_U8),
+  FIELD(p2G4_drec_cca_t, mod_found, P2G4_DBIN_U8),
+  FIELD(p2G4_drec_cca_t, rssi_overthreshold, P2G4_DBIN_U8),
+};
+
+static const p2G4_dbin_field_t modemrx_fields[] = {
+  HDR_FIELDS(p2G4_drec_modemrx_t),
+  FIELD(p2G4_drec_modemrx_t, time, P2G4_DBIN_U64),
+  FIELD(p2G4_drec_modemrx_t, SNR_total, P2G4_DBIN_F64),
+  FIELD(p2G4_drec_modemrx_t, SNR_analog_o, P2G4_DBIN_F64),
+  FIELD(p2G4_drec_modemrx_t, SNR_ISI, P2G4_DBIN_F64),
+  FIELD(p2G4_drec_modemrx_t, tx_nbr, P2G4_DBIN_U32),
+  FIELD(p2G4_drec_modemrx_t, CalNotRecal, P2G4_DBIN_U32),
+  FIELD(p2G4_drec_modemrx_t, BER, P2G4_DBIN_U32),
+  FIELD(p2G4_drec_modemrx_t, sync_prob, P2G4_DBIN_U32),
+  FIELD(p2G4_drec_modemrx_t, n_devs, P2G4_DBIN_U32),
+  FIELD(p2G4_drec_modemrx_t, n_tx, P2G4_DBIN_U32),
+  FIELD(p2G4_drec_modemrx_t, center_freq, P2G4_DBIN_U16),
+  FIELD(p2G4_drec_modemrx_t, modulation, P2G4_DBIN_U16),
+  FIELD(p2G4_drec_modemrx_t, coding_rate, P2G4_DBIN_U16),
+};
+
+#define N_FIELDS(a) (sizeof(a)/sizeof(a[0]))
+
+static const struct {
+  const p2G4_dbin_field_t *fields;
+  uint n_fields;
+} stream_fields[P2G4_DS_N] = {
+  { tx_fields, N_FIELDS(tx_fields) },
+  { rx_fields, N_FIELDS(rx_fields) },
+  { rssi_fields, N_FIELDS(rssi_fields) },
+  { cca_fields, N_FIELDS(cca_fields) },
+  { modemrx_fields, N_FIELDS(modemrx_fields) },
+};
+
+FILE *dbin_open_write(const char *filename, p2G4_dump_stream_t stream, uint dev, uint n_devs) {
+  FILE *f = bs_fopen(filename, "wb");
+
+  dbin_write_header(f, stream, dev, n_devs);
+  return f;
+}
+
+void dbin_write_header(FILE *f, p2G4_dump_stream_t stream, uint dev, uint n_devs) {
+  p2G4_dbin_header_t header;
+
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, P2G4_DBIN_MAGIC, sizeof(header.magic));
+  header.version = P2G4_DBIN_VERSION;
+  header.endianness = P2G4_DBIN_ENDIANNESS;
+  header.stream = stream;
+  header.dev = dev;
+  header.n_devs = n_devs;
+  header.rec_size = dbin_rec_size[stream];
+  header.n_fields = stream_fields[stream].n_fields;
+  strncpy(header.stream_name, dbin_stream_name[stream], sizeof(header.stream_name) - 1);
+
+  fwrite(&header, sizeof(header), 1, f);
+  fwrite(stream_fields[stream].fields, sizeof(p2G4_dbin_field_t), header.n_fields, f);
+}
+
+void dbin_write(FILE *f, p2G4_dump_stream_t stream, const p2G4_drec_hdr_t *rec, const void *var) {
+  fwrite(rec, dbin_rec_size[stream], 1, f);
+  if (rec->var_size > 0) {
+    fwrite(var, rec->var_size, 1, f);
+  }
+}
+
+/*
+ * Reading
+ */
+
+typedef struct {
+  uint32_t from; /* Offset in the file record */
+  uint32_t to;   /* Offset in our record */
+  uint32_t size;
+} dbin_map_t;
+
+struct dbin_reader_s {
+  const uint8_t *map; /* The whole file, mapped */
+  size_t map_size;
+  size_t pos;         /* Offset of the next record */
+  p2G4_dbin_header_t header;
+  bool same_layout; /* The file records are exactly as ours */
+  dbin_map_t *map_f; /* Otherwise, how to map them */
+  uint n_map;
+  uint8_t *rec;      /* Record in our layout */
+  uint8_t *var;
+  size_t var_alloc;
+};
+
+static void dbin_build_map(dbin_reader_t *r, const p2G4_dbin_field_t *file_fields) {
+  const p2G4_dbin_field_t *ours = stream_fields[r->header.stream].fields;
+  uint n_ours = stream_fields[r->header.stream].n_fields;
+
+  r->same_layout = (r->header.n_fields == n_ours)
+                   && (r->header.rec_size == dbin_rec_size[r->header.stream])
+                   && (memcmp(file_fields, ours, n_ours*sizeof(p2G4_dbin_field_t)) == 0);
+  if (r->same_layout) {
+    return;
+  }
+
+  r->map_f = bs_calloc(n_ours, sizeof(dbin_map_t));
+  for (uint i = 0; i < n_ours; i++) {
+    for (uint j = 0; j < r->header.n_fields; j++) {
+      const p2G4_dbin_field_t *ff = &file_fields[j];
+      if ((strncmp(ff->name, ours[i].name, P2G4_DBIN_NAME_MAX) == 0)
+          && (ff->type == ours[i].type)
+          && (ff->offset + ff->size <= r->header.rec_size)) {
+        r->map_f[r->n_map].from = ff->offset;
+        r->map_f[r->n_map].to = ours[i].offset;
+        r->map_f[r->n_map].size = BS_MIN(ff->size, ours[i].size);
+        r->n_map++;
+        break;
+      }
+    }
+  }
+}
+
+dbin_reader_t *dbin_open_read(const char *filename) {
+  dbin_reader_t *r;
+  struct stat st;
+  void *map;
+  int fd;
+
+  fd = open(filename, O_RDONLY);
+  if (fd == -1) {
+    bs_trace_warning_line("Could not open %s\n", filename);
+    return NULL;
+  }
+  if ((fstat(fd, &st) != 0) || (st.st_size < (off_t)sizeof(p2G4_dbin_header_t))) {
+    bs_trace_warning_line("%s is not a binary dump file\n", filename);
+    close(fd);
+    return NULL;
+  }
+  map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (map == MAP_FAILED) {
+    bs_trace_warning_line("Could not map %s\n", filename);
+    return NULL;
+  }
+  posix_madvise(map, st.st_size, POSIX_MADV_SEQUENTIAL);
+
+  r = bs_calloc(1, sizeof(dbin_reader_t));
+  r->map = map;
+  r->map_size = st.st_size;
+  memcpy(&r->header, r->map, sizeof(r->header));
+
+  if (memcmp(r->header.magic, P2G4_DBIN_MAGIC, sizeof(r->header.magic)) != 0) {
+    bs_trace_warning_line("%s is not a binary dump file\n", filename);
+    dbin_close(r);
+    return NULL;
+  }
+  if (r->header.endianness != P2G4_DBIN_ENDIANNESS) {
+    bs_trace_warning_line("%s was produced in a machine with different endianness\n", filename);
+    dbin_close(r);
+    return NULL;
+  }
+  if ((r->header.version != P2G4_DBIN_VERSION) || (r->header.stream >= P2G4_DS_N)) {
+    bs_trace_warning_line("%s binary dump version (%u) or stream (%u) not supported\n",
+                          filename, r->header.version, r->header.stream);
+    dbin_close(r);
+    return NULL;
+  }
+
+  size_t fields_size = (size_t)r->header.n_fields * sizeof(p2G4_dbin_field_t);
+  if (sizeof(r->header) + fields_size > r->map_size) {
+    bs_trace_warning_line("%s is truncated\n", filename);
+    dbin_close(r);
+    return NULL;
+  }
+  p2G4_dbin_field_t *fields = bs_malloc(fields_size + 1);
+  memcpy(fields, r->map + sizeof(r->header), fields_size);
+  dbin_build_map(r, fields);
+  free(fields);
+
+  r->pos = sizeof(r->header) + fields_size;
+  r->rec = bs_calloc(1, BS_MAX(dbin_rec_size[r->header.stream], r->header.rec_size));
+  return r;
+}
+
+const p2G4_dbin_header_t *dbin_header(dbin_reader_t *r) {
+  return &r->header;
+}
+
+const p2G4_dbin_field_t *dbin_fields(p2G4_dump_stream_t stream, uint *n_fields) {
+  *n_fields = stream_fields[stream].n_fields;
+  return stream_fields[stream].fields;
+}
+
+const p2G4_drec_hdr_t *dbin_next(dbin_reader_t *r, const void **var) {
+  p2G4_drec_hdr_t *h;
+  const uint8_t *file_rec = r->map + r->pos;
+
+  if (r->pos + r->header.rec_size > r->map_size) {
+    return NULL;
+  }
+
+  if (r->same_layout) {
+    memcpy(r->rec, file_rec, r->header.rec_size);
+  } else {
+    memset(r->rec, 0, dbin_rec_size[r->header.stream]);
+    for (uint i = 0; i < r->n_map; i++) {
+      memcpy(&r->rec[r->map_f[i].to], &file_rec[r->map_f[i].from], r->map_f[i].size);
+    }
+  }
+  h = (p2G4_drec_hdr_t *)r->rec;
+
+  if (r->pos + r->header.rec_size + h->var_size > r->map_size) {
+    return NULL; /* Truncated record */
+  }
+  if (h->var_size > r->var_alloc) {
+    r->var = bs_realloc(r->var, h->var_size);
+    r->var_alloc = h->var_size;
+  }
+  /* Copied out, as in the file it is not necessarily aligned */
+  memcpy(r->var, file_rec + r->header.rec_size, h->var_size);
+  r->pos += r->header.rec_size + h->var_size;
+
+  *var = r->var;
+  return h;
+}
+
+size_t dbin_tell(dbin_reader_t *r) {
+  return r->pos;
+}
+
+void dbin_seek(dbin_reader_t *r, size_t pos) {
+  r->pos = pos;
+}
+
+void dbin_close(dbin_reader_t *r) {
+  if (r == NULL) {
+    return;
+  }
+  munmap((void *)r->map, r->map_size);
+  free(r->map_f);
+  free(r->rec);
+  free(r->var);
+  free(r);
+}
@@ -0,0 +1,142 @@
+/*
+ * Copyright 2026 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#ifndef P2G4_DUMP_BIN_H
+#define P2G4_DUMP_BIN_H
+
+#include <stdio.h>
+#include "bs_types.h"
+#include "p2G4_dump_rec.h"
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/**
+ * Binary dump files
+ *
+ * One file per device and stream (d_<phy_id>_<dev>.<stream>.bin), with:
+ *  * A header (p2G4_dbin_header_t) followed by n_fields field descriptors
+ *    (p2G4_dbin_field_t) describing the fixed part of the records
+ *  * The records, each being its fixed part (rec_size bytes) followed by
+ *    its variable part (h.var_size bytes)
+ *
+ * Records are stored in the native byte order of the machine which produced
+ * them (the header endianness marker allows detecting a mismatch).
+ * The reader maps the fields of the file into the records of this build by
+ * name, so files produced by a Phy with a different (older/newer) record
+ * layout can still be read (fields it does not know are ignored, and fields
+ * missing in the file are left as 0).
+ */
+
+#define P2G4_DBIN_MAGIC "P2G4DBIN"
+#define P2G4_DBIN_VERSION 1
+#define P2G4_DBIN_ENDIANNESS 0x01020304
+#define P2G4_DBIN_NAME_MAX 32
+/* Header dev of multiplexed files (records from all devices) */
+#define P2G4_DBIN_ALL_DEVS 0xFFFFFFFF
+
+typedef struct {
+  char magic[8];
+  uint32_t version;
+  uint32_t endianness;
+  uint32_t stream;   /* One of p2G4_dump_stream_t */
+  uint32_t dev;      /* Device number (or P2G4_DBIN_ALL_DEVS) */
+  uint32_t n_devs;   /* Number of devices in the simulation */
+  uint32_t rec_size; /* Size of the records fixed part */
+  uint32_t n_fields; /* Number of field descriptors following the header */
+  uint32_t pad;
+  char stream_name[16];
+} p2G4_dbin_header_t;
+
+/* Field types */
+#define P2G4_DBIN_U8  1
+#define P2G4_DBIN_U16 2
+#define P2G4_DBIN_U32 3
+#define P2G4_DBIN_U64 4
+#define P2G4_DBIN_I16 5
+#define P2G4_DBIN_I32 6
+#define P2G4_DBIN_F64 7
+
+typedef struct {
+  char name[P2G4_DBIN_NAME_MAX];
+  uint32_t type;   /* One of P2G4_DBIN_* */
+  uint32_t count;  /* Number of elements (> 1 for arrays) */
+  uint32_t offset; /* Offset in the record fixed part */
+  uint32_t size;   /* Total size in bytes */
+} p2G4_dbin_field_t;
+
+/**
+ * Name of each stream (as in d_<phy_id>_<dev>.<name>.bin)
+ */
+extern const char *const dbin_stream_name[P2G4_DS_N];
+
+/**
+ * Size of the records fixed part of each stream
+ */
+extern const size_t dbin_rec_size[P2G4_DS_N];
+
+/**
+ * Create a binary dump file and write its header
+ */
+FILE *dbin_open_write(const char *filename, p2G4_dump_stream_t stream, uint dev, uint n_devs);
+
+/**
+ * Write the header of a binary dump file into an already open file
+ */
+void dbin_write_header(FILE *f, p2G4_dump_stream_t stream, uint dev, uint n_devs);
+
+/**
+ * Write a record (fixed part <rec>, of the stream size, and variable part <var>
+ * of rec->h.var_size bytes)
+ */
+void dbin_write(FILE *f, p2G4_dump_stream_t stream, const p2G4_drec_hdr_t *rec, const void *var);
+
+typedef struct dbin_reader_s dbin_reader_t;
+
+/**
+ * Open a binary dump file for reading (NULL if it cannot be opened or is
+ * not a valid binary dump)
+ * The file is memory mapped, so records can be revisited cheaply
+ */
+dbin_reader_t *dbin_open_read(const char *filename);
+
+/**
+ * Header of the file being read
+ */
+const p2G4_dbin_header_t *dbin_header(dbin_reader_t *r);
+
+/**
+ * Read the next record. Returns a pointer to its fixed part (in this build
+ * layout), and in *var to its variable part; or NULL when there is no more.
+ * The pointers are valid until the next call
+ */
+const p2G4_drec_hdr_t *dbin_next(dbin_reader_t *r, const void **var);
+
+/**
+ * Position of the next record in the file (to come back to it with dbin_seek())
+ */
+size_t dbin_tell(dbin_reader_t *r);
+
+/**
+ * Continue reading from a position obtained with dbin_tell()
+ */
+void dbin_seek(dbin_reader_t *r, size_t pos);
+
+/**
+ * Field descriptors of the records fixed part of a stream (in this build layout)
+ */
+const p2G4_dbin_field_t *dbin_fields(p2G4_dump_stream_t stream, uint *n_fields);
+
+/**
+ * Close a file opened with dbin_open_read()
+ */
+void dbin_close(dbin_reader_t *r);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,583 @@
+/*
+ * Copyright 2026 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Dump compare engine (see p2G4_dump_cmp.h)
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "bs_types.h"
+#include "bs_tracing.h"
+#include "bs_oswrap.h"
+#include "bs_utils.h"
+#include "p2G4_dump_cmp.h"
+#include "p2G4_dump_bin.h"
+
+/* Max number of differences reported in detail per file (the rest are only counted) */
+#define MAX_REPORTED 15
+
+/* How many reference entries ahead we look for a match to resync */
+#define RESYNC_WINDOW 64
+
+/*
+ * Reference entries of one device, in file order
+ *
+ * Multiplexed files are in the order the records were completed, not in
+ * time order, but the records of each device are in order (as in the per
+ * device files). So for those, the entries of each device are compared and
+ * resynchronized separately. Per device files have a single lane.
+ */
+typedef struct {
+  size_t *idx; /* Index of each of its entries in the reference index */
+  size_t n;
+  size_t alloc;
+  size_t cur;  /* Next one to compare with */
+} lane_t;
+
+struct dcmp_s {
+  const char *type;
+  int dev;          /* < 0 for multiplexed files (all devices) */
+  char who[64];     /* "Device <dev>, <type>" for reporting */
+  char who_chk[64]; /* Same, for the final statistics */
+  bool stop_on_diff;
+  bool bin;
+  p2G4_dump_stream_t stream;
+
+  /* CSV reference */
+  const char *map;
+  size_t map_size;
+  uint32_t *len; /* Length of each line */
+  char **col;    /* Heading column names */
+  uint n_col;
+
+  /* Binary reference */
+  dbin_reader_t *r;
+
+  /* Index of the reference entries */
+  size_t *pos;
+  uint64_t *time;
+  size_t n;
+  lane_t *lanes;
+  uint n_lanes;
+
+  uint32_t n_cmp;     /* Produced entries */
+  uint32_t n_diff;    /* Found with differences */
+  uint32_t n_missing; /* Produced, but not in the reference */
+  uint32_t n_extra;   /* In the reference, but not produced */
+  uint32_t n_reported;
+};
+
+static lane_t *get_lane(dcmp_t *c, uint lane) {
+  if (lane >= c->n_lanes) {
+    c->lanes = bs_realloc(c->lanes, (lane + 1)*sizeof(lane_t));
+    memset(&c->lanes[c->n_lanes], 0, (lane + 1 - c->n_lanes)*sizeof(lane_t));
+    c->n_lanes = lane + 1;
+  }
+  return &c->lanes[lane];
+}
+
+static void index_add(dcmp_t *c, size_t *alloc, size_t pos, uint64_t time, uint lane) {
+  lane_t *l = get_lane(c, lane);
+
+  if (l->n >= l->alloc) {
+    l->alloc = BS_MAX(1024, l->alloc*2);
+    l->idx = bs_realloc(l->idx, l->alloc*sizeof(size_t));
+  }
+  l->idx[l->n++] = c->n;
+
+  if (c->n >= *alloc) {
+    *alloc = BS_MAX(1024, *alloc*2);
+    c->pos = bs_realloc(c->pos, *alloc*sizeof(size_t));
+    c->time = bs_realloc(c->time, *alloc*sizeof(uint64_t));
+    if (!c->bin) {
+      c->len = bs_realloc(c->len, *alloc*sizeof(uint32_t));
+    }
+  }
+  c->pos[c->n] = pos;
+  c->time[c->n] = time;
+  c->n++;
+}
+
+/**
+ * Find the next column in <s> (of <len> chars) starting at *p
+ * (commas inside double quotes do not separate columns)
+ * Returns false if there is no more columns
+ */
+static bool next_col(const char *s, size_t len, size_t *p, size_t *start, size_t *col_len) {
+  bool quoted = false;
+  size_t i = *p;
+
+  if (i > len) {
+    return false;
+  }
+  *start = i;
+  while ((i < len) && (quoted || (s[i] != ','))) {
+    if (s[i] == '"') {
+      quoted = !quoted;
+    }
+    i++;
+  }
+  *col_len = i - *start;
+  *p = i + 1;
+  return true;
+}
+
+static void parse_heading(dcmp_t *c, const char *s, size_t len) {
+  size_t p = 0, start, col_len;
+  uint alloc = 0;
+
+  while (next_col(s, len, &p, &start, &col_len)) {
+    while ((col_len > 0) && (s[start] == ' ')) {
+      start++;
+      col_len--;
+    }
+    if (c->n_col >= alloc) {
+      alloc = BS_MAX(16, alloc*2);
+      c->col = bs_realloc(c->col, alloc*sizeof(char *));
+    }
+    c->col[c->n_col] = bs_calloc(col_len + 1, 1);
+    memcpy(c->col[c->n_col], &s[start], col_len);
+    c->n_col++;
+  }
+}
+
+/**
+ * Lane of a CSV line (its device in multiplexed files)
+ */
+static uint line_lane(dcmp_t *c, const char *line) {
+  return (c->dev < 0) ? strtoul(line, NULL, 10) : 0;
+}
+
+/**
+ * Time of a CSV line (1st column, or 2nd in multiplexed files after the device)
+ */
+static uint64_t line_time(dcmp_t *c, const char *line, size_t len) {
+  if (c->dev < 0) {
+    const char *comma = memchr(line, ',', len);
+    return (comma != NULL) ? strtoull(comma + 1, NULL, 10) : 0;
+  }
+  return strtoull(line, NULL, 10);
+}
+
+static dcmp_t *new_cmp(const char *type, int dev, bool stop_on_diff) {
+  dcmp_t *c = bs_calloc(1, sizeof(dcmp_t));
+
+  c->type = type;
+  c->dev = dev;
+  if (dev >= 0) {
+    snprintf(c->who, sizeof(c->who), "Device %i, %s", dev, type);
+    snprintf(c->who_chk, sizeof(c->who_chk), "Device %2i, %s", dev, type);
+  } else {
+    snprintf(c->who, sizeof(c->who), "All devices, %s", type);
+    snprintf(c->who_chk, sizeof(c->who_chk), "All devices, %s", type);
+  }
+  c->stop_on_diff = stop_on_diff;
+  return c;
+}
+
+static void free_cmp(dcmp_t *c) {
+  if (c->map != NULL) {
+    munmap((void *)c->map, c->map_size);
+  }
+  for (uint i = 0; i < c->n_col; i++) {
+    free(c->col[i]);
+  }
+  free(c->col);
+  free(c->len);
+  dbin_close(c->r);
+  for (uint i = 0; i < c->n_lanes; i++) {
+    free(c->lanes[i].idx);
+  }
+  free(c->lanes);
+  free(c->pos);
+  free(c->time);
+  free(c);
+}
+
+dcmp_t *dcmp_open_csv(const char *filename, const char *type, int dev, bool stop_on_diff) {
+  struct stat st;
+  size_t alloc = 0;
+  int fd;
+
+  fd = open(filename, O_RDONLY);
+  if (fd == -1) {
+    bs_trace_error_line("Could not open %s\n", filename);
+  }
+  if ((fstat(fd, &st) != 0) || (st.st_size == 0)) {
+    close(fd);
+    bs_trace_warning_line("%s file %s empty => won't be checked\n", type, filename);
+    return NULL;
+  }
+
+  dcmp_t *c = new_cmp(type, dev, stop_on_diff);
+  c->map_size = st.st_size;
+  c->map = mmap(NULL, c->map_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (c->map == MAP_FAILED) {
+    bs_trace_error_line("Could not map %s\n", filename);
+  }
+  posix_madvise((void *)c->map, c->map_size, POSIX_MADV_SEQUENTIAL);
+
+  bool heading = true;
+  size_t p = 0;
+  while (p < c->map_size) {
+    const char *nl = memchr(&c->map[p], '\n', c->map_size - p);
+    size_t end = (nl != NULL) ? (size_t)(nl - c->map) : c->map_size;
+
+    if (heading) {
+      parse_heading(c, &c->map[p], end - p);
+      heading = false;
+    } else if (end > p) {
+      index_add(c, &alloc, p, line_time(c, &c->map[p], end - p), line_lane(c, &c->map[p]));
+      c->len[c->n - 1] = end - p;
+    }
+    p = end + 1;
+  }
+
+  if (c->n == 0) {
+    bs_trace_warning_line("%s file %s empty => won't be checked\n", type, filename);
+    free_cmp(c);
+    return NULL;
+  }
+  return c;
+}
+
+dcmp_t *dcmp_open_bin(const char *filename, p2G4_dump_stream_t stream, int dev,
+                      bool stop_on_diff) {
+  dbin_reader_t *r = dbin_open_read(filename);
+  const p2G4_drec_hdr_t *rec;
+  const void *var;
+  size_t alloc = 0;
+
+  if (r == NULL) {
+    bs_trace_error_line("Could not open %s as a binary dump file\n", filename);
+  }
+  if (dbin_header(r)->stream != stream) {
+    bs_trace_error_line("%s does not contain %s records\n", filename, dbin_stream_name[stream]);
+  }
+
+  dcmp_t *c = new_cmp(dbin_stream_name[stream], dev, stop_on_diff);
+  c->bin = true;
+  c->stream = stream;
+  c->r = r;
+
+  size_t pos = dbin_tell(r);
+  while ((rec = dbin_next(r, &var)) != NULL) {
+    index_add(c, &alloc, pos, rec->time, (dev < 0) ? rec->dev : 0);
+    pos = dbin_tell(r);
+  }
+
+  if (c->n == 0) {
+    bs_trace_warning_line("%s file %s empty => won't be checked\n", c->type, filename);
+    free_cmp(c);
+    return NULL;
+  }
+  return c;
+}
+
+/**
+ * Account for a difference, and tell if it should be reported in detail
+ */
+static bool report(dcmp_t *c) {
+  c->n_reported++;
+  if (c->n_reported == MAX_REPORTED + 1) {
+    bs_trace_warning_line("%s: Too many differences. "
+                          "Further ones will only be counted\n", c->who);
+  }
+  return c->n_reported <= MAX_REPORTED;
+}
+
+static void check_stop(dcmp_t *c) {
+  if (c->stop_on_diff) {
+    bs_trace_error("Simulation terminated due to differences in kill mode\n");
+  }
+}
+
+/*
+ * CSV entries
+ */
+
+static bool csv_equal(dcmp_t *c, size_t i, const char *line, size_t len) {
+  return (c->len[i] == len) && (memcmp(&c->map[c->pos[i]], line, len) == 0);
+}
+
+static void csv_col_name(dcmp_t *c, uint idx, char *name, size_t size) {
+  uint g = 0; /* Trailing group of repeated columns (named "<something>[i]") */
+
+  while ((g < c->n_col) && (strstr(c->col[c->n_col - 1 - g], "[i]") != NULL)) {
+    g++;
+  }
+  if ((g > 0) && (idx >= c->n_col - g)) {
+    uint k = (idx - (c->n_col - g)) / g;
+    const char *base = c->col[c->n_col - g + (idx - (c->n_col - g)) % g];
+    snprintf(name, size, "%.*s[%u]", (int)(strstr(base, "[i]") - base), base, k);
+  } else if (idx < c->n_col) {
+    snprintf(name, size, "%s", c->col[idx]);
+  } else {
+    snprintf(name, size, "column %u", idx);
+  }
+}
+
+static void csv_report_diff(dcmp_t *c, size_t i, const char *line, size_t len) {
+  const char *ref = &c->map[c->pos[i]];
+  size_t ref_len = c->len[i];
+  size_t p = 0, q = 0, s1 = 0, l1 = 0, s2 = 0, l2 = 0;
+  bool more1 = true, more2 = true;
+  char name[64];
+
+  bs_trace_raw(1, "Comp: %s %u differs\n", c->who, c->n_cmp);
+  bs_trace_raw(2, "Comp: Read:\"%.*s\"\n", (int)ref_len, ref);
+  bs_trace_raw(2, "Comp:      \"%.*s\"\n", (int)len, line);
+
+  for (uint idx = 0; more1 || more2; idx++) {
+    more1 = more1 && next_col(ref, ref_len, &p, &s1, &l1);
+    more2 = more2 && next_col(line, len, &q, &s2, &l2);
+    if (!more1 && !more2) {
+      break;
+    }
+    if (more1 && more2 && (l1 == l2) && (memcmp(&ref[s1], &line[s2], l1) == 0)) {
+      continue;
+    }
+    csv_col_name(c, idx, name, sizeof(name));
+    bs_trace_raw(2, "Comp:   %s: read \"%.*s\", now \"%.*s\"\n", name,
+                 more1 ? (int)l1 : 5, more1 ? &ref[s1] : "<eol>",
+                 more2 ? (int)l2 : 5, more2 ? &line[s2] : "<eol>");
+  }
+}
+
+static void csv_report_missing(dcmp_t *c, const char *line, size_t len) {
+  bs_trace_raw(1, "Comp: %s %u not found in the reference\n",
+               c->who, c->n_cmp);
+  bs_trace_raw(2, "Comp:      \"%.*s\"\n", (int)len, line);
+}
+
+static void csv_report_extra(dcmp_t *c, size_t i) {
+  bs_trace_raw(1, "Comp: %s reference line %zu was not produced\n",
+               c->who, i + 2);
+  bs_trace_raw(2, "Comp: Read:\"%.*s\"\n", (int)c->len[i], &c->map[c->pos[i]]);
+}
+
+/*
+ * Binary entries
+ */
+
+static const p2G4_drec_hdr_t *bin_entry(dcmp_t *c, size_t i, const void **var) {
+  dbin_seek(c->r, c->pos[i]);
+  return dbin_next(c->r, var);
+}
+
+static bool bin_equal(dcmp_t *c, size_t i, const p2G4_drec_hdr_t *rec, const void *var) {
+  const void *ref_var;
+  const p2G4_drec_hdr_t *ref = bin_entry(c, i, &ref_var);
+
+  return (ref != NULL)
+         && (memcmp(ref, rec, dbin_rec_size[c->stream]) == 0)
+         && ((rec->var_size == 0) || (memcmp(ref_var, var, rec->var_size) == 0));
+}
+
+static void field_str(char *buf, size_t size, uint32_t type, const uint8_t *p, uint el_size) {
+  union { uint8_t u8; uint16_t u16; uint32_t u32; uint64_t u64;
+          int16_t i16; int32_t i32; double f64; } v;
+
+  memcpy(&v, p, BS_MIN(sizeof(v), el_size));
+  switch (type) {
+  case P2G4_DBIN_U8:  snprintf(buf, size, "%u", v.u8); break;
+  case P2G4_DBIN_U16: snprintf(buf, size, "%u", v.u16); break;
+  case P2G4_DBIN_U32: snprintf(buf, size, "%u", v.u32); break;
+  case P2G4_DBIN_U64: snprintf(buf, size, "%"PRIu64, v.u64); break;
+  case P2G4_DBIN_I16: snprintf(buf, size, "%i", v.i16); break;
+  case P2G4_DBIN_I32: snprintf(buf, size, "%i", v.i32); break;
+  case P2G4_DBIN_F64: snprintf(buf, size, "%.17g", v.f64); break;
+  default:            snprintf(buf, size, "?"); break;
+  }
+}
+
+static void bin_report_diff(dcmp_t *c, size_t i, const p2G4_drec_hdr_t *rec, const void *var) {
+  const void *ref_var;
+  const uint8_t *ref = (const uint8_t *)bin_entry(c, i, &ref_var);
+  const uint8_t *now = (const uint8_t *)rec;
+  const p2G4_dbin_field_t *fields;
+  uint n_fields;
+  char v1[32], v2[32];
+
+  bs_trace_raw(1, "Comp: %s %u (@%"PRIu64") differs\n",
+               c->who, c->n_cmp, rec->time);
+
+  fields = dbin_fields(c->stream, &n_fields);
+  for (uint f = 0; f < n_fields; f++) {
+    uint el_size = fields[f].size / fields[f].count;
+    for (uint e = 0; e < fields[f].count; e++) {
+      uint off = fields[f].offset + e*el_size;
+      if (memcmp(&ref[off], &now[off], el_size) == 0) {
+        continue;
+      }
+      field_str(v1, sizeof(v1), fields[f].type, &ref[off], el_size);
+      field_str(v2, sizeof(v2), fields[f].type, &now[off], el_size);
+      if (fields[f].count > 1) {
+        bs_trace_raw(2, "Comp:   %s[%u]: read %s, now %s\n", fields[f].name, e, v1, v2);
+      } else {
+        bs_trace_raw(2, "Comp:   %s: read %s, now %s\n", fields[f].name, v1, v2);
+      }
+    }
+  }
+  uint32_t ref_var_size = ((const p2G4_drec_hdr_t *)ref)->var_size;
+  if (ref_var_size == rec->var_size) {
+    for (uint32_t b = 0; b < rec->var_size; b++) {
+      if (((const uint8_t *)ref_var)[b] != ((const uint8_t *)var)[b]) {
+        bs_trace_raw(2, "Comp:   variable part differs from byte %u\n", b);
+        break;
+      }
+    }
+  }
+}
+
+static void bin_report_missing(dcmp_t *c, const p2G4_drec_hdr_t *rec) {
+  bs_trace_raw(1, "Comp: %s %u (@%"PRIu64") not found in the reference\n",
+               c->who, c->n_cmp, rec->time);
+}
+
+static void bin_report_extra(dcmp_t *c, size_t i) {
+  bs_trace_raw(1, "Comp: %s reference record %zu (@%"PRIu64") was not produced\n",
+               c->who, i + 1, c->time[i]);
+}
+
+/*
+ * Common comparison logic
+ */
+
+typedef struct {
+  const char *line;
+  size_t len;
+  const p2G4_drec_hdr_t *rec;
+  const void *var;
+  uint64_t time;
+  uint lane;
+} produced_t;
+
+static bool entry_equal(dcmp_t *c, size_t i, const produced_t *p) {
+  if (c->bin) {
+    return bin_equal(c, i, p->rec, p->var);
+  }
+  return csv_equal(c, i, p->line, p->len);
+}
+
+static void extra(dcmp_t *c, size_t i) {
+  c->n_extra++;
+  if (report(c)) {
+    c->bin ? bin_report_extra(c, i) : csv_report_extra(c, i);
+  }
+}
+
+static void compare(dcmp_t *c, const produced_t *p) {
+  lane_t *l = get_lane(c, p->lane);
+
+  c->n_cmp++;
+
+  while (true) {
+    if (l->cur >= l->n) {
+      c->n_missing++;
+      if (report(c)) {
+        c->bin ? bin_report_missing(c, p->rec) : csv_report_missing(c, p->line, p->len);
+      }
+      break;
+    }
+    size_t cur = l->idx[l->cur];
+
+    if (entry_equal(c, cur, p)) {
+      l->cur++;
+      return;
+    }
+
+    /* Is the reference ahead with extra entries? */
+    for (size_t k = 1; (k <= RESYNC_WINDOW) && (l->cur + k < l->n)
+                       && (c->time[l->idx[l->cur + k]] <= p->time); k++) {
+      if (entry_equal(c, l->idx[l->cur + k], p)) {
+        for (size_t i = l->cur; i < l->cur + k; i++) {
+          extra(c, l->idx[i]);
+        }
+        l->cur += k + 1;
+        check_stop(c);
+        return;
+      }
+    }
+
+    if (c->time[cur] == p->time) {
+      c->n_diff++;
+      if (report(c)) {
+        c->bin ? bin_report_diff(c, cur, p->rec, p->var)
+               : csv_report_diff(c, cur, p->line, p->len);
+      }
+      l->cur++;
+      break;
+    }
+    if (c->time[cur] > p->time) {
+      c->n_missing++;
+      if (report(c)) {
+        c->bin ? bin_report_missing(c, p->rec) : csv_report_missing(c, p->line, p->len);
+      }
+      break;
+    }
+    extra(c, cur);
+    l->cur++;
+  }
+  check_stop(c);
+}
+
+void dcmp_csv(dcmp_t *c, const char *line, size_t len) {
+  produced_t p = { .line = line, .len = len, .time = line_time(c, line, len),
+                   .lane = line_lane(c, line) };
+  compare(c, &p);
+}
+
+void dcmp_bin(dcmp_t *c, const p2G4_drec_hdr_t *rec, const void *var) {
+  produced_t p = { .rec = rec, .var = var, .time = rec->time,
+                   .lane = (c->dev < 0) ? rec->dev : 0 };
+  compare(c, &p);
+}
+
+int dcmp_close(dcmp_t *c) {
+  int tracel;
+
+  if (c == NULL) {
+    return 0;
+  }
+
+  /*
+   * Whatever is left in the reference after the last produced entry was not
+   * produced. As a simulation may just be shorter than its reference, this is
+   * only reported, not counted as a difference
+   */
+  uint32_t n_left = 0;
+  for (uint i = 0; i < c->n_lanes; i++) {
+    n_left += c->lanes[i].n - c->lanes[i].cur;
+  }
+
+  uint32_t n_err = c->n_diff + c->n_missing + c->n_extra;
+  if ((c->n_cmp > 0) || (n_err > 0)) {
+    tracel = (n_err == 0) ? 4 : 1;
+    bs_trace_raw(tracel, "Check: %s: found %i/%i differences (%.1f%%)\n",
+                 c->who_chk, n_err, c->n_cmp,
+                 n_err*100.0/(float)BS_MAX(c->n_cmp, 1));
+    if (c->n_missing + c->n_extra > 0) {
+      bs_trace_raw(tracel, "Check: %s: %u different, %u not in the reference, "
+                   "%u reference ones not produced\n",
+                   c->who_chk, c->n_diff, c->n_missing, c->n_extra);
+    }
+  }
+  if (n_left > 0) {
+    bs_trace_raw(3, "Check: %s: the last %u reference entries were not produced "
+                 "(not counted as differences)\n", c->who_chk, n_left);
+  }
+
+  free_cmp(c);
+  return (n_err != 0);
+}
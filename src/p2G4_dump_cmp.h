@@ -0,0 +1,73 @@
+/*
+ * Copyright 2026 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#ifndef P2G4_DUMP_CMP_H
+#define P2G4_DUMP_CMP_H
+
+#include "bs_types.h"
+#include "p2G4_dump_rec.h"
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/**
+ * Dump compare engine
+ *
+ * Compares what the Phy would dump with reference dump files (CSV or binary)
+ *
+ * The reference file is memory mapped and indexed (position and time of each
+ * line/record) once when opened. Each produced line/record is compared
+ * with the next reference one:
+ *  * If they match, both advance.
+ *  * If a matching reference entry is found a bit ahead (with a time not after
+ *    the produced one), the reference entries in between are reported as
+ *    extra in the reference, and the comparison resyncs there.
+ *  * If the reference entry has the same time, it is reported as different
+ *    (field by field).
+ *  * Otherwise, based on their times, either the produced entry is reported
+ *    as missing in the reference, or the reference entry as not produced.
+ * So a missing or extra entry does not cause all following ones to be
+ * reported as different.
+ */
+
+typedef struct dcmp_s dcmp_t;
+
+/**
+ * Open a reference CSV file (<type> is the file type name, for reporting)
+ * <dev> < 0 for multiplexed files (all devices, with a leading device column)
+ * Returns NULL if it only has the heading (empty)
+ */
+dcmp_t *dcmp_open_csv(const char *filename, const char *type, int dev, bool stop_on_diff);
+
+/**
+ * Open a reference binary dump file of the stream
+ * (<dev> < 0 for multiplexed files)
+ * Returns NULL if it has no records (empty)
+ */
+dcmp_t *dcmp_open_bin(const char *filename, p2G4_dump_stream_t stream, int dev,
+                      bool stop_on_diff);
+
+/**
+ * Compare a produced CSV line (without end of line)
+ */
+void dcmp_csv(dcmp_t *c, const char *line, size_t len);
+
+/**
+ * Compare a produced record
+ */
+void dcmp_bin(dcmp_t *c, const p2G4_drec_hdr_t *rec, const void *var);
+
+/**
+ * Print the comparison statistics and free the comparison
+ * Returns 1 if any difference was found, 0 otherwise
+ */
+int dcmp_close(dcmp_t *c);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
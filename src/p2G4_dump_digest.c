@@ -0,0 +1,204 @@
+/*
+ * Copyright 2026 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Dump digests (see p2G4_dump_digest.h)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include "bs_types.h"
+#include "bs_tracing.h"
+#include "bs_oswrap.h"
+#include "bs_utils.h"
+#include "p2G4_dump_digest.h"
+#include "p2G4_dump_bin.h"
+#include "p2G4_xxh64.h"
+
+typedef struct {
+  bs_time_t time;
+  uint64_t n;      /* Records before this time */
+  uint64_t digest; /* Of those records */
+} ddig_cp_t;
+
+typedef struct {
+  p2G4_xxh64_t h;
+  uint64_t n;
+  bs_time_t last_time;
+  bs_time_t next_cp;
+  ddig_cp_t *cps;
+  uint n_cps;
+  uint alloc_cps;
+} ddig_stream_t;
+
+static ddig_stream_t *streams = NULL; /* [dev][stream] */
+static uint n_devs;
+static bs_time_t cp_period;
+
+static void add_cp(ddig_stream_t *s, bs_time_t time, uint64_t n, uint64_t digest) {
+  if (s->n_cps >= s->alloc_cps) {
+    s->alloc_cps = (s->alloc_cps == 0) ? 64 : s->alloc_cps*2;
+    s->cps = bs_realloc(s->cps, s->alloc_cps*sizeof(ddig_cp_t));
+  }
+  s->cps[s->n_cps].time = time;
+  s->cps[s->n_cps].n = n;
+  s->cps[s->n_cps].digest = digest;
+  s->n_cps++;
+}
+
+void ddig_init(uint n_devs_i, bs_time_t cp_period_i) {
+  n_devs = n_devs_i;
+  cp_period = cp_period_i;
+  streams = bs_calloc(n_devs*P2G4_DS_N, sizeof(ddig_stream_t));
+  for (uint i = 0; i < n_devs*P2G4_DS_N; i++) {
+    p2G4_xxh64_reset(&streams[i].h, 0);
+    streams[i].next_cp = cp_period;
+  }
+}
+
+void ddig_record(p2G4_dump_stream_t stream, const p2G4_drec_hdr_t *rec, const void *var) {
+  ddig_stream_t *s = &streams[rec->dev*P2G4_DS_N + stream];
+
+  if ((cp_period > 0) && (rec->time >= s->next_cp)) {
+    /* Only the last boundary before this record is kept (no repeated checkpoints while idle) */
+    bs_time_t cp_time = (rec->time / cp_period) * cp_period;
+    add_cp(s, cp_time, s->n, p2G4_xxh64_digest(&s->h));
+    s->next_cp = cp_time + cp_period;
+  }
+
+  p2G4_xxh64_update(&s->h, rec, dbin_rec_size[stream]);
+  if (rec->var_size > 0) {
+    p2G4_xxh64_update(&s->h, var, rec->var_size);
+  }
+  s->n++;
+  s->last_time = rec->time;
+}
+
+void ddig_write_manifest(const char *filename) {
+  FILE *f = bs_fopen(filename, "w");
+  p2G4_xxh64_t all;
+
+  p2G4_xxh64_reset(&all, 0);
+
+  fprintf(f, "type,dev,stream,time,records,xxh64\n");
+  for (uint d = 0; d < n_devs; d++) {
+    for (int st = 0; st < P2G4_DS_N; st++) {
+      ddig_stream_t *s = &streams[d*P2G4_DS_N + st];
+      uint64_t digest = p2G4_xxh64_digest(&s->h);
+
+      for (uint i = 0; i < s->n_cps; i++) {
+        fprintf(f, "cp,%u,%s,%"PRItime",%"PRIu64",0x%016"PRIx64"\n", d, dbin_stream_name[st],
+                s->cps[i].time, s->cps[i].n, s->cps[i].digest);
+      }
+      fprintf(f, "total,%u,%s,%"PRItime",%"PRIu64",0x%016"PRIx64"\n", d, dbin_stream_name[st],
+              s->last_time, s->n, digest);
+      p2G4_xxh64_update(&all, &s->n, sizeof(s->n));
+      p2G4_xxh64_update(&all, &digest, sizeof(digest));
+    }
+  }
+  fclose(f);
+
+  bs_trace_raw(2, "Dump digest: 0x%016"PRIx64" (manifest in %s)\n",
+               p2G4_xxh64_digest(&all), filename);
+}
+
+/**
+ * Compare our stream digests <s> with those from the reference <ref>
+ */
+static int compare_stream(uint d, int st, ddig_stream_t *s, ddig_stream_t *ref) {
+  uint64_t digest = p2G4_xxh64_digest(&s->h);
+  bs_time_t from = 0;
+  uint i;
+
+  if ((s->n == ref->n) && (digest == ref->cps[ref->n_cps - 1].digest)) {
+    bs_trace_raw(4, "Check: Device %2i, %s: digests match (%"PRIu64" records)\n",
+                 d, dbin_stream_name[st], s->n);
+    return 0;
+  }
+
+  for (i = 0; (i < s->n_cps) && (i < ref->n_cps - 1); i++) {
+    if ((s->cps[i].time != ref->cps[i].time) || (s->cps[i].n != ref->cps[i].n)
+        || (s->cps[i].digest != ref->cps[i].digest)) {
+      break;
+    }
+    from = s->cps[i].time;
+  }
+  if ((i < s->n_cps) && (i < ref->n_cps - 1)) {
+    bs_trace_raw(1, "Check: Device %2i, %s: digests diverge between %"PRItime" and %"PRItime"\n",
+                 d, dbin_stream_name[st], from, BS_MIN(s->cps[i].time, ref->cps[i].time));
+  } else {
+    bs_trace_raw(1, "Check: Device %2i, %s: digests diverge after %"PRItime"\n",
+                 d, dbin_stream_name[st], from);
+  }
+  bs_trace_raw(2, "Check: Device %2i, %s: %"PRIu64" records now, %"PRIu64" in the reference\n",
+               d, dbin_stream_name[st], s->n, ref->n);
+  return 1;
+}
+
+int ddig_compare_manifest(const char *filename) {
+  FILE *f = bs_fopen(filename, "r");
+  ddig_stream_t *refs = bs_calloc(n_devs*P2G4_DS_N, sizeof(ddig_stream_t));
+  char line[256], type[16], stream[16];
+  uint d;
+  bs_time_t time;
+  uint64_t n, digest;
+  int ret_error = 0;
+
+  while (fgets(line, sizeof(line), f) != NULL) {
+    if (sscanf(line, "%15[^,],%u,%15[^,],%"SCNu64",%"SCNu64",0x%"SCNx64,
+               type, &d, stream, &time, &n, &digest) != 6) {
+      continue; /* Heading */
+    }
+    int st;
+    for (st = 0; st < P2G4_DS_N; st++) {
+      if (strcmp(stream, dbin_stream_name[st]) == 0) {
+        break;
+      }
+    }
+    if ((d >= n_devs) || (st == P2G4_DS_N)) {
+      bs_trace_warning_line("%s: ignoring unknown device/stream %u,%s\n", filename, d, stream);
+      continue;
+    }
+    ddig_stream_t *ref = &refs[d*P2G4_DS_N + st];
+    /* The total is kept as the last "checkpoint" */
+    add_cp(ref, time, n, digest);
+    if (strcmp(type, "total") == 0) {
+      ref->n = n;
+    }
+  }
+  fclose(f);
+
+  for (d = 0; d < n_devs; d++) {
+    for (int st = 0; st < P2G4_DS_N; st++) {
+      ddig_stream_t *ref = &refs[d*P2G4_DS_N + st];
+      if (ref->n_cps == 0) {
+        bs_trace_warning_line("%s: no digest for device %u %s => won't be checked\n",
+                              filename, d, dbin_stream_name[st]);
+        continue;
+      }
+      ret_error |= compare_stream(d, st, &streams[d*P2G4_DS_N + st], ref);
+    }
+  }
+
+  for (uint i = 0; i < n_devs*P2G4_DS_N; i++) {
+    free(refs[i].cps);
+  }
+  free(refs);
+  return ret_error;
+}
+
+void ddig_free(void) {
+  if (streams == NULL) {
+    return;
+  }
+  for (uint i = 0; i < n_devs*P2G4_DS_N; i++) {
+    free(streams[i].cps);
+  }
+  free(streams);
+  streams = NULL;
+}
@@ -0,0 +1,57 @@
+/*
+ * Copyright 2026 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#ifndef P2G4_DUMP_DIGEST_H
+#define P2G4_DUMP_DIGEST_H
+
+#include "bs_types.h"
+#include "p2G4_dump_rec.h"
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/**
+ * Dump digests
+ *
+ * Instead of dumping, a rolling XXH64 digest is kept per device and stream over
+ * the canonical bytes of the dump records (see p2G4_dump_rec.h).
+ * Every <cp_period> of simulated time a checkpoint (digest of all records
+ * before that time) is taken, so when 2 runs differ, the manifests tell
+ * in which period they diverged.
+ *
+ * The manifest is a CSV file with the columns:
+ *   type,dev,stream,time,records,xxh64
+ * with one "cp" line per checkpoint (time being the checkpoint time), and a
+ * "total" line per device and stream (time being the last record time)
+ */
+
+void ddig_init(uint n_devs, bs_time_t cp_period);
+
+/**
+ * Account for a record (of the stream fixed size followed by rec->var_size
+ * bytes from <var>)
+ */
+void ddig_record(p2G4_dump_stream_t stream, const p2G4_drec_hdr_t *rec, const void *var);
+
+/**
+ * Write the digest manifest into <filename>, and print the overall digest
+ */
+void ddig_write_manifest(const char *filename);
+
+/**
+ * Compare the digests with those in the manifest <filename>, reporting for
+ * each device and stream in which checkpoint period they first diverge
+ * Returns 1 if any difference was found, 0 otherwise
+ */
+int ddig_compare_manifest(const char *filename);
+
+void ddig_free(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,230 @@
+/*
+ * Copyright 2026 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <math.h>
+#include "bs_tracing.h"
+#include "bs_oswrap.h"
+#include "bs_pc_2G4_utils.h"
+#include "p2G4_dump_filter.h"
+
+/* Names accepted in the streams list (some streams have 2) */
+static const struct {
+  const char *name;
+  p2G4_dump_stream_t stream;
+} stream_names[] = {
+  { "Tx", P2G4_DS_TX }, { "Txv2", P2G4_DS_TX },
+  { "Rx", P2G4_DS_RX }, { "Rxv2", P2G4_DS_RX },
+  { "RSSI", P2G4_DS_RSSI },
+  { "CCA", P2G4_DS_CCA },
+  { "ModemRx", P2G4_DS_MODEMRX },
+};
+
+static uint n_dev;
+/* Per device bitmask of selected streams */
+static uint8_t *selected = NULL;
+static uint8_t any_selected;
+
+static bs_time_t t_from, t_to;
+/* Selected frequencies (NULL = all) */
+static double *freqs = NULL;
+static uint n_freqs;
+/* Selected addresses (NULL = all) */
+static p2G4_address_t *addrs = NULL;
+static uint n_addrs;
+
+/**
+ * Count the comma separated elements in a list
+ */
+static uint list_len(const char *list) {
+  uint n = 1;
+  for (const char *c = list; *c != 0; c++) {
+    n += (*c == ',');
+  }
+  return n;
+}
+
+static void parse_devs(const char *list, bool *devs) {
+  const char *c = list;
+
+  while (true) {
+    char *end;
+    unsigned long first, last;
+
+    first = strtoul(c, &end, 10);
+    if (end == c) {
+      break;
+    }
+    last = first;
+    if (*end == '-') {
+      c = end + 1;
+      last = strtoul(c, &end, 10);
+      if ((end == c) || (last < first)) {
+        break;
+      }
+    }
+    if (last >= n_dev) {
+      bs_trace_error_line("Dump filter: device %lu does not exist (%u devices)\n",
+                          last, n_dev);
+    }
+    for (unsigned long d = first; d <= last; d++) {
+      devs[d] = true;
+    }
+    if (*end == 0) {
+      return;
+    } else if (*end != ',') {
+      break;
+    }
+    c = end + 1;
+  }
+  bs_trace_error_line("Dump filter: cannot parse the devices list '%s'\n", list);
+}
+
+static uint8_t parse_streams(const char *list) {
+  const char *c = list;
+  uint8_t mask = 0;
+
+  while (true) {
+    size_t len = strcspn(c, ",");
+    int i;
+    for (i = 0; i < (int)(sizeof(stream_names)/sizeof(stream_names[0])); i++) {
+      if ((strlen(stream_names[i].name) == len)
+          && (strncasecmp(c, stream_names[i].name, len) == 0)) {
+        mask |= 1 << stream_names[i].stream;
+        break;
+      }
+    }
+    if (i == sizeof(stream_names)/sizeof(stream_names[0])) {
+      bs_trace_error_line("Dump filter: unknown stream '%.*s' (valid: Tx, Rx, RSSI, CCA, ModemRx)\n",
+                          (int)len, c);
+    }
+    if (c[len] == 0) {
+      return mask;
+    }
+    c += len + 1;
+  }
+}
+
+static void parse_freqs(const char *list) {
+  const char *c = list;
+
+  freqs = bs_calloc(list_len(list), sizeof(double));
+  n_freqs = 0;
+  while (true) {
+    char *end;
+    freqs[n_freqs++] = strtod(c, &end);
+    if ((end == c) || ((*end != ',') && (*end != 0))) {
+      bs_trace_error_line("Dump filter: cannot parse the frequencies list '%s'\n", list);
+    }
+    if (*end == 0) {
+      return;
+    }
+    c = end + 1;
+  }
+}
+
+static void parse_addrs(const char *list) {
+  const char *c = list;
+
+  addrs = bs_calloc(list_len(list), sizeof(p2G4_address_t));
+  n_addrs = 0;
+  while (true) {
+    char *end;
+    addrs[n_addrs++] = strtoull(c, &end, 0);
+    if ((end == c) || ((*end != ',') && (*end != 0))) {
+      bs_trace_error_line("Dump filter: cannot parse the addresses list '%s'\n", list);
+    }
+    if (*end == 0) {
+      return;
+    }
+    c = end + 1;
+  }
+}
+
+void dflt_init(const p2G4_dump_filter_t *filter, uint n_devs) {
+  uint8_t streams = (1 << P2G4_DS_N) - 1;
+  bool devs[n_devs];
+
+  n_dev = n_devs;
+  memset(devs, filter->devs == NULL, sizeof(devs));
+  if (filter->devs != NULL) {
+    parse_devs(filter->devs, devs);
+  }
+  if (filter->streams != NULL) {
+    streams = parse_streams(filter->streams);
+  }
+
+  selected = bs_calloc(n_devs, sizeof(uint8_t));
+  any_selected = 0;
+  for (uint d = 0; d < n_devs; d++) {
+    selected[d] = devs[d] ? streams : 0;
+    any_selected |= selected[d];
+  }
+
+  t_from = filter->from;
+  t_to = filter->to;
+  if (t_to < t_from) {
+    bs_trace_error_line("Dump filter: empty time window (%"PRItime" to %"PRItime")\n",
+                        t_from, t_to);
+  }
+  if (filter->freqs != NULL) {
+    parse_freqs(filter->freqs);
+  }
+  if (filter->addrs != NULL) {
+    parse_addrs(filter->addrs);
+  }
+}
+
+void dflt_free(void) {
+  free(selected);
+  selected = NULL;
+  free(freqs);
+  freqs = NULL;
+  free(addrs);
+  addrs = NULL;
+}
+
+bool dflt_selected(uint dev, p2G4_dump_stream_t stream) {
+  if (selected == NULL) {
+    return false;
+  }
+  return (selected[dev] >> stream) & 1;
+}
+
+bool dflt_stream_selected(p2G4_dump_stream_t stream) {
+  return (any_selected >> stream) & 1;
+}
+
+bool dflt_pass(bs_time_t time, p2G4_freq_t center_freq) {
+  if ((time < t_from) || (time > t_to)) {
+    return false;
+  }
+  if (freqs == NULL) {
+    return true;
+  }
+  double f = p2G4_freq_to_d(center_freq);
+  for (uint i = 0; i < n_freqs; i++) {
+    if (fabs(f - freqs[i]) < 1e-3) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool dflt_addr_pass(const p2G4_address_t *a, uint n) {
+  if (addrs == NULL) {
+    return true;
+  }
+  for (uint i = 0; i < n; i++) {
+    for (uint j = 0; j < n_addrs; j++) {
+      if (a[i] == addrs[j]) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
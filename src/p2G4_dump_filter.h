@@ -0,0 +1,70 @@
+/*
+ * Copyright 2026 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#ifndef P2G4_DUMP_FILTER_H
+#define P2G4_DUMP_FILTER_H
+
+#include "bs_types.h"
+#include "bs_pc_2G4_types.h"
+#include "p2G4_dump_rec.h"
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/**
+ * Dump filters
+ *
+ * Select which records are dumped (or compared, or digested):
+ *  * devs:    list of devices and device ranges (for ex. "0,3-5")
+ *  * streams: list of streams (Tx, Rx, RSSI, CCA, ModemRx)
+ *  * from/to: simulated time window, checked against each record main time
+ *             (start of the Tx, Rx or CCA, RSSI measurement or modem invocation time)
+ *  * freqs:   list of center frequencies (in MHz above 2400, as in the dumps)
+ *  * addrs:   list of phy addresses. Only applies to Tx and Rx records
+ *             (an Rx passes if any of the addresses it searched for is in the list)
+ * NULL lists select everything.
+ *
+ * The device and stream selection is fixed, so no file is created for what is
+ * not selected. The other filters are checked per record, before it is built.
+ */
+typedef struct {
+  const char *devs;
+  const char *streams;
+  bs_time_t from;
+  bs_time_t to;
+  const char *freqs;
+  const char *addrs;
+} p2G4_dump_filter_t;
+
+void dflt_init(const p2G4_dump_filter_t *filter, uint n_devs);
+
+void dflt_free(void);
+
+/**
+ * Is this stream selected for this device
+ */
+bool dflt_selected(uint dev, p2G4_dump_stream_t stream);
+
+/**
+ * Is this stream selected for any device
+ */
+bool dflt_stream_selected(p2G4_dump_stream_t stream);
+
+/**
+ * Does a record with this main time and center frequency pass the filters
+ */
+bool dflt_pass(bs_time_t time, p2G4_freq_t center_freq);
+
+/**
+ * Does any of these <n> phy addresses pass the address filter
+ */
+bool dflt_addr_pass(const p2G4_address_t *addrs, uint n);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
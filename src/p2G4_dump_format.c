@@ -0,0 +1,410 @@
+/*
+ * Copyright 2026 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <stdio.h>
+#include <stdarg.h>
+#include <inttypes.h>
+#include "bs_types.h"
+#include "bs_utils.h"
+#include "bs_pc_2G4_types.h"
+#include "bs_pc_2G4_utils.h"
+#include "bs_rand_main.h"
+#include "p2G4_dump_format.h"
+
+const char *const dfmt_file_name[P2G4_DF_N] = {
+  "Tx", "Rx", "Txv2", "Rxv2", "RSSI", "CCA", "ModemRx", "ModemRxSparse"
+};
+
+const char *const dfmt_heading[P2G4_DF_N] = {
+  /* Tx */
+  "start_time,end_time,center_freq,"
+  "phy_address,modulation,power_level,abort_time,"
+  "recheck_time,packet_size,packet\n",
+  /* Rx */
+  "start_time,scan_duration,phy_address,modulation,"
+  "center_freq,antenna_gain,sync_threshold,header_threshold,"
+  "pream_and_addr_duration,"
+  "header_duration,bps,abort_time,recheck_time,"
+  "tx_nbr,biterrors,sync_end,header_end,"
+  "payload_end,rx_time_stamp,status,RSSI,"
+  "packet_size,packet\n",
+  /* Txv2 */
+  "start_tx_time,end_tx_time,"
+  "start_packet_time, end_packet_time, center_freq,"
+  "phy_address,modulation,coding_rate,power_level,abort_time,"
+  "recheck_time,packet_size,packet\n",
+  /* Rxv2 */
+  "start_time,scan_duration,n_addr,phy_address[],modulation,"
+  "center_freq,antenna_gain,"
+  "acceptable_pre_truncation,sync_threshold,header_threshold,"
+  "pream_and_addr_duration,"
+  "header_duration,error_calc_rate,"
+  "forced_packet_duration,coding_rate,prelocked_tx,"
+  "resp_type,"
+  "abort_time,recheck_time,"
+  "tx_nbr,matched_addr,tx_coding_rate,biterrors,sync_end,header_end,"
+  "payload_end,rx_time_stamp,status,RSSI,"
+  "packet_size,packet\n",
+  /* RSSI */
+  "meas_time,modulation,center_freq,antenna_gain,RSSI\n",
+  /* CCA */
+  "start_time,scan_duration,scan_period,"
+  "modulation,center_freq,antenna_gain,"
+  "threshold_mod,threshold_rssi,stop_when_found,"
+  "abort_time,recheck_time,"
+  "end_time, RSSI_ave, RSSI_max, mod_rx_power,"
+  "mod_found, rssi_overthreshold\n",
+  /* ModemRx */
+  "time,tx_nbr,CalNotRecal,center_freq,modulation,"
+  "coding_rate,"
+  "BER,syncprob,SNR,anaSNR,ISISNR,att[i],rxpow[i]\n",
+  /* ModemRxSparse */
+  "time,tx_nbr,CalNotRecal,center_freq,modulation,"
+  "coding_rate,"
+  "BER,syncprob,SNR,anaSNR,ISISNR,n_tx,tx[i],att[i],rxpow[i]\n"
+};
+
+/**
+ * Continue formatting a line which already has <printed> characters,
+ * with snprintf() semantics for the whole line
+ */
+static int append(char *buf, size_t size, int printed, const char *format, ...) {
+  va_list args;
+  int n;
+
+  va_start(args, format);
+  if ((size_t)printed < size) {
+    n = vsnprintf(&buf[printed], size - printed, format, args);
+  } else {
+    n = vsnprintf(NULL, 0, format, args);
+  }
+  va_end(args);
+  return printed + n;
+}
+
+/**
+ * Append the packet hex representation (if there is a packet)
+ */
+static int append_packet(char *buf, size_t size, int printed, const uint8_t *packet,
+                         uint32_t packet_size, const char *hex) {
+  if (packet_size == 0) {
+    return printed;
+  }
+  if (hex != NULL) {
+    return append(buf, size, printed, "%s", hex);
+  }
+  char hex_tmp[packet_size*3 + 1];
+  bs_hex_dump(hex_tmp, packet, packet_size);
+  return append(buf, size, printed, "%s", hex_tmp);
+}
+
+int dfmt_txv1(char *buf, size_t size, const p2G4_drec_tx_t *r,
+               const uint8_t *packet, const char *hex) {
+  int printed;
+
+  printed = snprintf(buf, size,
+                    "%"PRItime",%"PRItime","
+                    "%.6f,"
+                    "0x%08X,%u,"
+                    "%.6f,"
+                    "%"PRItime",%"PRItime","
+                    "%u,",
+                    r->start_tx_time, r->end_tx_time,
+                    p2G4_freq_to_d(r->center_freq),
+                    (uint32_t)r->phy_address, r->modulation,
+                    p2G4_power_to_d(r->power_level),
+                    r->abort_time, r->recheck_time,
+                    r->packet_size);
+
+  return append_packet(buf, size, printed, packet, r->h.var_size, hex);
+}
+
+int dfmt_txv2(char *buf, size_t size, const p2G4_drec_tx_t *r,
+               const uint8_t *packet, const char *hex) {
+  int printed;
+
+  printed = snprintf(buf, size,
+                    "%"PRItime",%"PRItime","
+                    "%"PRItime",%"PRItime","
+                    "%.6f,"
+                    "0x%08X,%u,"
+                    "%u,"
+                    "%.6f,"
+                    "%"PRItime",%"PRItime","
+                    "%u,",
+                    r->start_tx_time, r->end_tx_time,
+                    r->start_packet_time, r->end_packet_time,
+                    p2G4_freq_to_d(r->center_freq),
+                    (uint32_t)r->phy_address, r->modulation,
+                    r->coding_rate,
+                    p2G4_power_to_d(r->power_level),
+                    r->abort_time, r->recheck_time,
+                    r->packet_size);
+
+  return append_packet(buf, size, printed, packet, r->h.var_size, hex);
+}
+
+int dfmt_rxv1(char *buf, size_t size, const p2G4_drec_rx_t *r,
+               const uint8_t *packet, const char *hex) {
+  int printed;
+
+  printed = snprintf(buf, size,
+                    "%"PRItime",%u,"
+                    "0x%08X,%u,"
+                    "%.6f,"
+                    "%.6f,"
+                    "%u,%u,"
+                    "%u,"
+                    "%u,%u,%"PRItime",%"PRItime","
+                    "%i,%u,%"PRItime",%"PRItime","
+                    "%"PRItime",%"PRItime",%u,"
+                    "%.6f,"
+                    "%u,",
+                    r->start_time, r->scan_duration,
+                    (uint32_t)r->phy_address[0], r->modulation,
+                    p2G4_freq_to_d(r->center_freq),
+                    p2G4_power_to_d(r->antenna_gain),
+                    r->sync_threshold, r->header_threshold,
+                    r->pream_and_addr_duration,
+                    r->header_duration, r->error_calc_rate, r->abort_time, r->recheck_time,
+
+                    r->tx_nbr,
+                    r->biterrors,
+                    r->sync_end,
+                    r->header_end,
+
+                    r->payload_end,
+                    r->rx_time_stamp,
+                    r->status,
+                    p2G4_RSSI_value_to_dBm(r->rssi),
+
+                    r->packet_size);
+
+  return append_packet(buf, size, printed, packet, r->h.var_size, hex);
+}
+
+int dfmt_rxv2(char *buf, size_t size, const p2G4_drec_rx_t *r,
+               const uint8_t *packet, const char *hex) {
+  int printed;
+
+  printed = snprintf(buf, size,
+                    "%"PRItime",%u,"
+                    "%u,\"[",
+                    r->start_time, r->scan_duration,
+                    r->n_addr);
+
+  for (int i = 0 ; i < r->n_addr ; i++) {
+    printed = append(buf, size, printed, "0x%08"PRIx64, r->phy_address[i]);
+    if (i < (int)r->n_addr - 1) {
+      printed = append(buf, size, printed, ",");
+    }
+  }
+
+  printed = append(buf, size, printed,
+                    "]\", %u,"
+                    "%.6f,"
+                    "%.6f,"
+
+                    "%u,"
+                    "%u,%u,"
+                    "%u,"
+                    "%u,%u,"
+
+                    "%u,"
+                    "%u,"
+                    "%u,"
+
+                    "%u,"
+                    "%"PRItime",%"PRItime","
+
+                    "%i,"
+                    "0x%08"PRIx64","
+                    "%u,"
+                    "%u,"
+                    "%"PRItime","
+                    "%"PRItime","
+
+                    "%"PRItime","
+                    "%"PRItime","
+                    "%u,"
+                    "%.6f,"
+
+                    "%u,",
+                    r->modulation,
+                    p2G4_freq_to_d(r->center_freq),
+                    p2G4_power_to_d(r->antenna_gain),
+
+                    r->acceptable_pre_truncation,
+                    r->sync_threshold, r->header_threshold,
+                    r->pream_and_addr_duration,
+                    r->header_duration, r->error_calc_rate,
+
+                    r->forced_packet_duration,
+                    r->coding_rate,
+                    r->prelocked_tx,
+
+                    r->resp_type,
+                    r->abort_time, r->recheck_time,
+
+                    r->tx_nbr,
+                    r->matched_address,
+                    r->tx_coding_rate,
+                    r->biterrors,
+                    r->sync_end,
+                    r->header_end,
+
+                    r->payload_end,
+                    r->rx_time_stamp,
+                    r->status,
+                    p2G4_RSSI_value_to_dBm(r->rssi),
+
+                    r->packet_size);
+
+  return append_packet(buf, size, printed, packet, r->h.var_size, hex);
+}
+
+int dfmt_rssi(char *buf, size_t size, const p2G4_drec_rssi_t *r) {
+  return snprintf(buf, size,
+      "%"PRItime","
+      "%u,%.6f,"
+      "%.6f,"
+      "%.6f",
+      r->meas_time,
+      r->modulation,
+      p2G4_freq_to_d(r->center_freq),
+      p2G4_power_to_d(r->antenna_gain),
+      p2G4_RSSI_value_to_dBm(r->rssi));
+}
+
+int dfmt_cca(char *buf, size_t size, const p2G4_drec_cca_t *r) {
+  return snprintf(buf, size,
+      "%"PRItime","
+      "%u,"
+      "%u,"
+
+      "%u,"
+      "%.6f,"
+      "%.6f,"
+
+      "%.6f,"
+      "%.6f,"
+      "%u,"
+
+      "%"PRItime",%"PRItime","
+
+      "%"PRItime","
+      "%.6f,"
+      "%.6f,"
+      "%.6f,"
+      "%u,%u"
+      ,
+
+      r->start_time,
+      r->scan_duration,
+      r->scan_period,
+
+      r->modulation,
+      p2G4_freq_to_d(r->center_freq),
+      p2G4_power_to_d(r->antenna_gain),
+
+      p2G4_RSSI_value_to_dBm(r->mod_threshold),
+      p2G4_RSSI_value_to_dBm(r->rssi_threshold),
+      r->stop_when_found,
+
+      r->abort_time, r->recheck_time,
+
+      r->end_time,
+      p2G4_RSSI_value_to_dBm(r->RSSI_ave),
+      p2G4_RSSI_value_to_dBm(r->RSSI_max),
+      p2G4_RSSI_value_to_dBm(r->mod_rx_power),
+      r->mod_found, r->rssi_overthreshold
+      );
+}
+
+/**
+ * Columns common to the dense and sparse ModemRx lines
+ */
+static int modemrx_common(char *buf, size_t size, const p2G4_drec_modemrx_t *r) {
+  return snprintf(buf, size,
+                  "%"PRItime",%u,"
+                  "%u,%f,%u,"
+                  "%u,"
+                  "%e,%e,"
+                  "%f,%f,%f",
+                  r->time,
+                  r->tx_nbr,
+
+                  r->CalNotRecal,
+                  p2G4_freq_to_d(r->center_freq),
+                  r->modulation,
+
+                  r->coding_rate,
+
+                  r->BER/(double)RAND_PROB_1,
+                  r->sync_prob/(double)RAND_PROB_1,
+
+                  r->SNR_total,
+                  r->SNR_analog_o,
+                  r->SNR_ISI);
+}
+
+int dfmt_modemrx(char *buf, size_t size, const p2G4_drec_modemrx_t *r,
+                 const p2G4_drec_modemrx_tx_t *txs) {
+  int printed = modemrx_common(buf, size, r);
+  uint32_t next = 0;
+
+  for (uint32_t tx = 0; tx < r->n_devs; tx++) {
+    if ((next < r->n_tx) && (txs[next].tx == tx)) {
+      printed = append(buf, size, printed, ",%f,%f", txs[next].att, txs[next].rx_pow);
+      next++;
+    } else {
+      printed = append(buf, size, printed, ",NaN, NaN");
+    }
+  }
+  return printed;
+}
+
+int dfmt_modemrx_sparse(char *buf, size_t size, const p2G4_drec_modemrx_t *r,
+                        const p2G4_drec_modemrx_tx_t *txs) {
+  int printed = modemrx_common(buf, size, r);
+
+  printed = append(buf, size, printed, ",%u", r->n_tx);
+  for (uint32_t i = 0; i < r->n_tx; i++) {
+    printed = append(buf, size, printed, ",%u,%f,%f", txs[i].tx, txs[i].att, txs[i].rx_pow);
+  }
+  return printed;
+}
+
+p2G4_dump_stream_t dfmt_file_stream(p2G4_dump_file_t file) {
+  static const p2G4_dump_stream_t stream[P2G4_DF_N] = {
+    P2G4_DS_TX, P2G4_DS_RX, P2G4_DS_TX, P2G4_DS_RX,
+    P2G4_DS_RSSI, P2G4_DS_CCA, P2G4_DS_MODEMRX, P2G4_DS_MODEMRX
+  };
+  return stream[file];
+}
+
+int dfmt_record(char *buf, size_t size, p2G4_dump_file_t file, const void *rec,
+                const void *var, const char *hex) {
+  switch (file) {
+  case P2G4_DF_TXV1:
+    return dfmt_txv1(buf, size, rec, var, hex);
+  case P2G4_DF_TXV2:
+    return dfmt_txv2(buf, size, rec, var, hex);
+  case P2G4_DF_RXV1:
+    return dfmt_rxv1(buf, size, rec, var, hex);
+  case P2G4_DF_RXV2:
+    return dfmt_rxv2(buf, size, rec, var, hex);
+  case P2G4_DF_RSSI:
+    return dfmt_rssi(buf, size, rec);
+  case P2G4_DF_CCA:
+    return dfmt_cca(buf, size, rec);
+  case P2G4_DF_MODEMRX:
+    return dfmt_modemrx(buf, size, rec, var);
+  case P2G4_DF_MODEMRXS:
+    return dfmt_modemrx_sparse(buf, size, rec, var);
+  default:
+    return 0;
+  }
+}
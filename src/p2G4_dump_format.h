@@ -0,0 +1,87 @@
+/*
+ * Copyright 2026 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#ifndef P2G4_DUMP_FORMAT_H
+#define P2G4_DUMP_FORMAT_H
+
+#include <stddef.h>
+#include "bs_types.h"
+#include "p2G4_dump_rec.h"
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/**
+ * Formatting of the dump records into the CSV files lines
+ *
+ * Shared by the Phy and the dump conversion tools, so the CSV files
+ * are the same no matter how they were produced.
+ *
+ * All dfmt_*() format a line (without the end of line) into <buf> with
+ * snprintf() semantics: they never write more than <size> bytes, and return
+ * the length the complete line has (which may be >= size).
+ *
+ * <packet> is the record packet (its variable part, of h.var_size bytes),
+ * and <hex> its hex representation (as per bs_hex_dump()) if the caller
+ * already has it, or NULL (it will be formatted from the packet)
+ */
+
+/* CSV files (the Tx and Rx records are dumped in both the v1 and v2 formats) */
+typedef enum {
+  P2G4_DF_TXV1 = 0,
+  P2G4_DF_RXV1,
+  P2G4_DF_TXV2,
+  P2G4_DF_RXV2,
+  P2G4_DF_RSSI,
+  P2G4_DF_CCA,
+  P2G4_DF_MODEMRX,
+  P2G4_DF_MODEMRXS, /* ModemRx, sparse: only the active transmitters */
+  P2G4_DF_N
+} p2G4_dump_file_t;
+
+/**
+ * Name of each CSV file type (as in d_<phy_id>_<dev>.<name>.csv)
+ */
+extern const char *const dfmt_file_name[P2G4_DF_N];
+
+/**
+ * Heading line of each CSV file type (with end of line)
+ */
+extern const char *const dfmt_heading[P2G4_DF_N];
+
+int dfmt_txv1(char *buf, size_t size, const p2G4_drec_tx_t *r,
+               const uint8_t *packet, const char *hex);
+int dfmt_txv2(char *buf, size_t size, const p2G4_drec_tx_t *r,
+               const uint8_t *packet, const char *hex);
+int dfmt_rxv1(char *buf, size_t size, const p2G4_drec_rx_t *r,
+               const uint8_t *packet, const char *hex);
+int dfmt_rxv2(char *buf, size_t size, const p2G4_drec_rx_t *r,
+               const uint8_t *packet, const char *hex);
+int dfmt_rssi(char *buf, size_t size, const p2G4_drec_rssi_t *r);
+int dfmt_cca(char *buf, size_t size, const p2G4_drec_cca_t *r);
+int dfmt_modemrx(char *buf, size_t size, const p2G4_drec_modemrx_t *r,
+                 const p2G4_drec_modemrx_tx_t *txs);
+int dfmt_modemrx_sparse(char *buf, size_t size, const p2G4_drec_modemrx_t *r,
+                        const p2G4_drec_modemrx_tx_t *txs);
+
+/**
+ * Format a record as the CSV file type <file> (which must be one of those
+ * of the record stream). <var> is the record variable part.
+ * <hex> as for the others (only used for Tx and Rx records)
+ */
+int dfmt_record(char *buf, size_t size, p2G4_dump_file_t file, const void *rec,
+                const void *var, const char *hex);
+
+/**
+ * Stream of the records dumped in the CSV file type <file>
+ */
+p2G4_dump_stream_t dfmt_file_stream(p2G4_dump_file_t file);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,83 @@
+/*
+ * Copyright 2026 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include "bs_types.h"
+#include "bs_tracing.h"
+#include "bs_oswrap.h"
+#include "p2G4_dump_idx.h"
+
+struct didx_s {
+  FILE *f;
+  bs_time_t period;
+  bs_time_t next; /* Next index time */
+  uint64_t records;
+};
+
+static FILE *open_idx(const char *filename, const char *mode) {
+  char idx_name[strlen(filename) + 8];
+  sprintf(idx_name, "%s.idx", filename);
+  return fopen(idx_name, mode);
+}
+
+didx_t *didx_open(const char *filename, bs_time_t period) {
+  didx_t *x = bs_calloc(1, sizeof(didx_t));
+
+  x->f = open_idx(filename, "w");
+  if (x->f == NULL) {
+    bs_trace_error_line("Could not create the index file for %s\n", filename);
+  }
+  x->period = period;
+  x->next = 0;
+  fputs("time,offset,record\n", x->f);
+  return x;
+}
+
+void didx_record(didx_t *x, bs_time_t time, FILE *file) {
+  if (time >= x->next) {
+    bs_time_t boundary = time - time % x->period;
+    fprintf(x->f, "%"PRItime",%ld,%"PRIu64"\n", boundary, ftell(file), x->records);
+    x->next = boundary + x->period;
+  }
+  x->records++;
+}
+
+void didx_close(didx_t *x) {
+  if (x == NULL) {
+    return;
+  }
+  fclose(x->f);
+  free(x);
+}
+
+bool didx_lookup(const char *filename, bs_time_t time, uint64_t *offset) {
+  FILE *f = open_idx(filename, "r");
+  char line[128];
+  bs_time_t t;
+  uint64_t off, rec;
+
+  if (f == NULL) {
+    return false;
+  }
+  *offset = 0;
+  if (fgets(line, sizeof(line), f) == NULL) { /* Heading */
+    fclose(f);
+    return false;
+  }
+  while (fgets(line, sizeof(line), f) != NULL) {
+    if (sscanf(line, "%"SCNu64",%"SCNu64",%"SCNu64, &t, &off, &rec) != 3) {
+      break;
+    }
+    if (t > time) {
+      break;
+    }
+    *offset = off;
+  }
+  fclose(f);
+  return true;
+}
@@ -0,0 +1,57 @@
+/*
+ * Copyright 2026 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#ifndef P2G4_DUMP_IDX_H
+#define P2G4_DUMP_IDX_H
+
+#include <stdio.h>
+#include "bs_types.h"
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/**
+ * Dump time indexes
+ *
+ * Next to each dump file <file>, a small <file>.idx CSV file with the columns
+ *   time,offset,record
+ * where each line tells that the first record in the dump file with a time
+ * >= <time> starts at byte <offset> of the file, and is its <record>th
+ * record (counting from 0).
+ * There is at most one line per index period, and only for periods with records.
+ * All records before <offset> have a time < <time>, so to find all records from
+ * a given time on, it is enough to start reading from the offset of the last
+ * line with a time <= that time.
+ * (Records after it are in the order they were dumped, which for the
+ * multiplexed files is not necessarily in time order)
+ */
+
+typedef struct didx_s didx_t;
+
+/**
+ * Start an index for the dump file <filename> with one entry every <period>
+ */
+didx_t *didx_open(const char *filename, bs_time_t period);
+
+/**
+ * A record with main time <time> is about to be written into <file>
+ */
+void didx_record(didx_t *x, bs_time_t time, FILE *file);
+
+void didx_close(didx_t *x);
+
+/**
+ * Find in the index of the dump file <filename> from which byte offset
+ * to read to get all records with time >= <time>.
+ * Returns false if there is no index (then read from the beginning)
+ */
+bool didx_lookup(const char *filename, bs_time_t time, uint64_t *offset);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
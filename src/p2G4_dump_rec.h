@@ -0,0 +1,167 @@
+/*
+ * Copyright 2026 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#ifndef P2G4_DUMP_REC_H
+#define P2G4_DUMP_REC_H
+
+#include "bs_types.h"
+#include "bs_pc_2G4_types.h"
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/**
+ * Dump records
+ *
+ * Everything the Phy dumps is first captured in one of these fixed width
+ * records (raw values, before any conversion to text), optionally followed
+ * by a variable size part (the packet, or the ModemRx per transmitter
+ * entries) of h.var_size bytes.
+ *
+ * The CSV files are formatted from these records (see p2G4_dump_format.h),
+ * and the binary dumps (see p2G4_dump_bin.h) contain them as they are.
+ *
+ * Records are always cleared before being filled, so they (padding included)
+ * have a canonical byte representation.
+ */
+
+/* Dumped streams (each one produces its own files) */
+typedef enum {
+  P2G4_DS_TX = 0,
+  P2G4_DS_RX,
+  P2G4_DS_RSSI,
+  P2G4_DS_CCA,
+  P2G4_DS_MODEMRX,
+  P2G4_DS_N
+} p2G4_dump_stream_t;
+
+/* Common record header */
+typedef struct {
+  uint64_t time;     /* Main time of the record (start of the Tx, Rx, CCA, or measurement time) */
+  uint32_t dev;      /* Device number */
+  uint32_t var_size; /* Bytes following the fixed part of the record */
+} p2G4_drec_hdr_t;
+
+/* Transmission. Followed by the packet */
+typedef struct {
+  p2G4_drec_hdr_t h;
+  uint64_t start_tx_time;
+  uint64_t end_tx_time;
+  uint64_t start_packet_time;
+  uint64_t end_packet_time;
+  uint64_t phy_address;
+  uint64_t abort_time;
+  uint64_t recheck_time;
+  uint16_t center_freq;
+  uint16_t modulation;
+  int16_t  power_level;
+  uint16_t coding_rate;
+  uint16_t packet_size;
+  uint16_t pad[3];
+} p2G4_drec_tx_t;
+
+/* Reception. Followed by the dumped part of the packet (if any) */
+typedef struct {
+  p2G4_drec_hdr_t h;
+  uint64_t start_time;
+  uint64_t abort_time;
+  uint64_t recheck_time;
+  uint64_t sync_end;
+  uint64_t header_end;
+  uint64_t payload_end;
+  uint64_t rx_time_stamp;
+  uint64_t matched_address; /* Response phy_address */
+  uint64_t phy_address[P2G4_RXV2_MAX_ADDRESSES];
+  uint32_t scan_duration;
+  uint32_t error_calc_rate;
+  uint32_t forced_packet_duration;
+  int32_t  tx_nbr;
+  uint32_t biterrors;
+  int32_t  rssi;
+  uint16_t modulation;
+  uint16_t center_freq;
+  int16_t  antenna_gain;
+  uint16_t acceptable_pre_truncation;
+  uint16_t sync_threshold;
+  uint16_t header_threshold;
+  uint16_t pream_and_addr_duration;
+  uint16_t header_duration;
+  uint16_t coding_rate;
+  uint16_t tx_coding_rate; /* Response coding_rate */
+  uint16_t packet_size;
+  uint8_t  n_addr;
+  uint8_t  prelocked_tx;
+  uint8_t  resp_type;
+  uint8_t  status;
+  uint8_t  pad[6];
+} p2G4_drec_rx_t;
+
+/* RSSI measurement */
+typedef struct {
+  p2G4_drec_hdr_t h;
+  uint64_t meas_time;
+  int32_t  rssi;
+  uint16_t modulation;
+  uint16_t center_freq;
+  int16_t  antenna_gain;
+  uint16_t pad[3];
+} p2G4_drec_rssi_t;
+
+/* CCA */
+typedef struct {
+  p2G4_drec_hdr_t h;
+  uint64_t start_time;
+  uint64_t abort_time;
+  uint64_t recheck_time;
+  uint64_t end_time;
+  uint32_t scan_duration;
+  uint32_t scan_period;
+  int32_t  mod_threshold;
+  int32_t  rssi_threshold;
+  int32_t  RSSI_ave;
+  int32_t  RSSI_max;
+  int32_t  mod_rx_power;
+  uint16_t modulation;
+  uint16_t center_freq;
+  int16_t  antenna_gain;
+  uint8_t  stop_when_found;
+  uint8_t  mod_found;
+  uint8_t  rssi_overthreshold;
+  uint8_t  pad[3];
+} p2G4_drec_cca_t;
+
+/* Modem model invocation. Followed by n_tx p2G4_drec_modemrx_tx_t */
+typedef struct {
+  p2G4_drec_hdr_t h;
+  uint64_t time;
+  double   SNR_total;
+  double   SNR_analog_o;
+  double   SNR_ISI;
+  uint32_t tx_nbr;
+  uint32_t CalNotRecal;
+  uint32_t BER;
+  uint32_t sync_prob;
+  uint32_t n_devs; /* Number of devices in the simulation */
+  uint32_t n_tx;   /* Number of active transmitters which follow */
+  uint16_t center_freq;
+  uint16_t modulation;
+  uint16_t coding_rate;
+  uint16_t pad;
+} p2G4_drec_modemrx_t;
+
+/* Each active transmitter in a ModemRx record */
+typedef struct {
+  uint32_t tx;
+  uint32_t pad;
+  double   att;
+  double   rx_pow;
+} p2G4_drec_modemrx_tx_t;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
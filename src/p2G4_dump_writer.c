@@ -0,0 +1,212 @@
+/*
+ * Copyright 2026 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Asynchronous dump writer (see p2G4_dump_writer.h)
+ *
+ * The ring contains entries, each one an entry header followed by the record
+ * (fixed and variable part), padded to 8 bytes.
+ * Entries are never split around the end of the ring (a skip entry fills the
+ * end instead), so the writer can hand them to the sink in place, aligned.
+ */
+
+#define _GNU_SOURCE
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include "bs_types.h"
+#include "bs_tracing.h"
+#include "bs_oswrap.h"
+#include "bs_utils.h"
+#include "p2G4_dump_writer.h"
+
+#define DWR_ALIGN(x) (((x) + 7) & ~(size_t)7)
+
+/* Special entry types (stream) */
+#define DWR_SKIP 0xFFFFFFFE /* Fill until the end of the ring */
+#define DWR_STOP 0xFFFFFFFF /* The writer should exit */
+
+typedef struct {
+  uint32_t size;   /* Complete entry size (header included, padded) */
+  uint32_t stream; /* p2G4_dump_stream_t, or DWR_SKIP/STOP */
+} dwr_entry_t;
+
+static struct {
+  uint8_t *data;
+  uint32_t size; /* Power of 2 */
+  uint32_t head; /* Written by the simulation thread */
+  uint32_t tail; /* Written by the writer thread (after the sink is done with the entry) */
+  uint32_t prod_waiting;
+  uint32_t cons_waiting;
+  dwr_sink_t sink;
+  pthread_t thread;
+  bool running;
+} ring;
+
+static int futex_wait(uint32_t *addr, uint32_t val) {
+  return syscall(SYS_futex, addr, FUTEX_WAIT_PRIVATE, val, NULL, NULL, 0);
+}
+
+static void futex_wake(uint32_t *addr) {
+  syscall(SYS_futex, addr, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+}
+
+/**
+ * Wait until *index changes from <old>
+ */
+static void wait_index_change(uint32_t *index, uint32_t old, uint32_t *waiting_flag) {
+  __atomic_store_n(waiting_flag, 1, __ATOMIC_SEQ_CST);
+  if (__atomic_load_n(index, __ATOMIC_SEQ_CST) == old) {
+    futex_wait(index, old);
+  }
+  __atomic_store_n(waiting_flag, 0, __ATOMIC_SEQ_CST);
+}
+
+static void *writer_thread(void *arg) {
+  (void)arg;
+
+  while (true) {
+    uint32_t tail = ring.tail;
+    uint32_t head = __atomic_load_n(&ring.head, __ATOMIC_ACQUIRE);
+
+    if (head == tail) {
+      wait_index_change(&ring.head, head, &ring.cons_waiting);
+      continue;
+    }
+
+    while (tail != head) {
+      dwr_entry_t *e = (dwr_entry_t *)&ring.data[tail & (ring.size - 1)];
+
+      if (e->stream == DWR_STOP) {
+        __atomic_store_n(&ring.tail, tail + e->size, __ATOMIC_SEQ_CST);
+        return NULL;
+      }
+      if (e->stream != DWR_SKIP) {
+        const p2G4_drec_hdr_t *rec = (const p2G4_drec_hdr_t *)(e + 1);
+        /* The variable part is at the end of the entry */
+        const uint8_t *var = (const uint8_t *)e + e->size - DWR_ALIGN(rec->var_size);
+        ring.sink(e->stream, rec, var);
+      }
+      tail += e->size;
+      __atomic_store_n(&ring.tail, tail, __ATOMIC_SEQ_CST);
+      if (__atomic_load_n(&ring.prod_waiting, __ATOMIC_SEQ_CST)) {
+        futex_wake(&ring.tail);
+      }
+    }
+  }
+  return NULL;
+}
+
+/**
+ * Reserve <size> contiguous bytes in the ring (waiting for space if needed)
+ * and return a pointer to them
+ */
+static uint8_t *reserve(uint32_t size) {
+  while (true) {
+    uint32_t head = ring.head;
+    uint32_t tail = __atomic_load_n(&ring.tail, __ATOMIC_ACQUIRE);
+    uint32_t free_space = ring.size - (head - tail);
+    uint32_t idx = head & (ring.size - 1);
+    uint32_t to_end = ring.size - idx;
+
+    if ((to_end < size) && (free_space >= to_end)) {
+      dwr_entry_t *skip = (dwr_entry_t *)&ring.data[idx];
+      skip->size = to_end;
+      skip->stream = DWR_SKIP;
+      __atomic_store_n(&ring.head, head + to_end, __ATOMIC_SEQ_CST);
+      continue;
+    }
+    if ((to_end >= size) && (free_space >= size)) {
+      return &ring.data[idx];
+    }
+    wait_index_change(&ring.tail, tail, &ring.prod_waiting);
+  }
+}
+
+static void commit(uint32_t size) {
+  __atomic_store_n(&ring.head, ring.head + size, __ATOMIC_SEQ_CST);
+  if (__atomic_load_n(&ring.cons_waiting, __ATOMIC_SEQ_CST)) {
+    futex_wake(&ring.head);
+  }
+}
+
+void dwr_start(dwr_sink_t sink, size_t ring_size) {
+  uint32_t size = 4096;
+
+  while ((size < ring_size) && (size < (1U << 30))) {
+    size <<= 1;
+  }
+  ring.data = bs_malloc(size);
+  ring.size = size;
+  ring.head = 0;
+  ring.tail = 0;
+  ring.sink = sink;
+
+  if (pthread_create(&ring.thread, NULL, writer_thread, NULL) != 0) {
+    bs_trace_warning_line("Could not start the dump writer thread, dumping synchronously\n");
+    free(ring.data);
+    ring.data = NULL;
+    return;
+  }
+  ring.running = true;
+}
+
+bool dwr_running(void) {
+  return ring.running;
+}
+
+void dwr_push(p2G4_dump_stream_t stream, const p2G4_drec_hdr_t *rec, size_t rec_size,
+              const void *var) {
+  /*
+   * The record fixed part is stored padded to 8 bytes, followed by the
+   * variable part padded to 8 bytes.
+   */
+  uint32_t fixed = DWR_ALIGN(rec_size);
+  uint32_t size = sizeof(dwr_entry_t) + fixed + DWR_ALIGN(rec->var_size);
+
+  if (size > ring.size / 2) {
+    /* Too big for the ring: Let the writer finish everything else and do it here */
+    uint32_t tail;
+    while ((tail = __atomic_load_n(&ring.tail, __ATOMIC_ACQUIRE)) != ring.head) {
+      wait_index_change(&ring.tail, tail, &ring.prod_waiting);
+    }
+    ring.sink(stream, rec, var);
+    return;
+  }
+
+  uint8_t *p = reserve(size);
+  dwr_entry_t *e = (dwr_entry_t *)p;
+
+  e->size = size;
+  e->stream = stream;
+  memcpy(e + 1, rec, rec_size);
+  if (rec->var_size > 0) {
+    memcpy((uint8_t *)(e + 1) + fixed, var, rec->var_size);
+  }
+  commit(size);
+}
+
+void dwr_stop(void) {
+  if (!ring.running) {
+    return;
+  }
+  if (pthread_equal(pthread_self(), ring.thread)) {
+    /* Exiting due to an error in the writer itself: leave it be */
+    return;
+  }
+  ring.running = false;
+
+  dwr_entry_t *e = (dwr_entry_t *)reserve(sizeof(dwr_entry_t));
+  e->size = sizeof(dwr_entry_t);
+  e->stream = DWR_STOP;
+  commit(sizeof(dwr_entry_t));
+
+  pthread_join(ring.thread, NULL);
+  free(ring.data);
+  ring.data = NULL;
+}
@@ -0,0 +1,60 @@
+/*
+ * Copyright 2026 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#ifndef P2G4_DUMP_WRITER_H
+#define P2G4_DUMP_WRITER_H
+
+#include <stddef.h>
+#include "bs_types.h"
+#include "p2G4_dump_rec.h"
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/**
+ * Asynchronous dump writer
+ *
+ * The simulation thread only copies the dump records into a single producer
+ * single consumer ring; a background thread takes them out and hands them to
+ * the sink (which formats and writes them) in the same order.
+ * When the ring is full the simulation thread waits for the writer to make
+ * space (back-pressure), so no record is ever lost.
+ */
+
+/**
+ * Function which formats/writes a record (called from the writer thread)
+ */
+typedef void (*dwr_sink_t)(p2G4_dump_stream_t stream, const p2G4_drec_hdr_t *rec,
+                           const void *var);
+
+/**
+ * Start the writer thread, with a ring of <ring_size> bytes (rounded up to a
+ * power of 2)
+ */
+void dwr_start(dwr_sink_t sink, size_t ring_size);
+
+/**
+ * Is the writer running
+ */
+bool dwr_running(void);
+
+/**
+ * Queue a record (fixed part of <rec_size> bytes, followed by rec->var_size
+ * bytes from <var>)
+ */
+void dwr_push(p2G4_dump_stream_t stream, const p2G4_drec_hdr_t *rec, size_t rec_size,
+              const void *var);
+
+/**
+ * Write out everything queued so far, and stop the writer thread
+ */
+void dwr_stop(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,81 @@
+/*
+ * Copyright 2026 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Compressed dump files (see p2G4_dump_z.h)
+ *
+ * A gzFile is wrapped in a stdio FILE (fopencookie), so the dump code
+ * writes to it as to any other file.
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include "bs_types.h"
+#include "bs_tracing.h"
+#include "p2G4_dump_z.h"
+
+/* Compression level: the dumps are mostly limited by the disk, but they are big */
+#define DZ_LEVEL "wb1"
+/* zlib and stdio buffers */
+#define DZ_BUF_SIZE (256*1024)
+
+#if defined(P2G4_HAVE_ZLIB)
+#include <zlib.h>
+
+bool dz_available(void) {
+  return true;
+}
+
+static ssize_t dz_write(void *cookie, const char *buf, size_t size) {
+  if (size == 0) {
+    return 0;
+  }
+  int written = gzwrite((gzFile)cookie, buf, size);
+  return (written > 0) ? written : -1;
+}
+
+static int dz_close(void *cookie) {
+  return (gzclose((gzFile)cookie) == Z_OK) ? 0 : EOF;
+}
+
+FILE *dz_fopen(const char *filename) {
+  cookie_io_functions_t funcs = {
+    .read = NULL,
+    .write = dz_write,
+    .seek = NULL,
+    .close = dz_close
+  };
+  gzFile gz;
+  FILE *f;
+
+  gz = gzopen(filename, DZ_LEVEL);
+  if (gz == NULL) {
+    bs_trace_error_line("Could not open %s (%s)\n", filename, strerror(errno));
+  }
+  gzbuffer(gz, DZ_BUF_SIZE);
+
+  f = fopencookie(gz, "w", funcs);
+  if (f == NULL) {
+    bs_trace_error_line("Could not open %s (%s)\n", filename, strerror(errno));
+  }
+  setvbuf(f, NULL, _IOFBF, DZ_BUF_SIZE);
+  return f;
+}
+
+#else /* !P2G4_HAVE_ZLIB */
+
+bool dz_available(void) {
+  return false;
+}
+
+FILE *dz_fopen(const char *filename) {
+  bs_trace_error_line("Phy built without compression support, cannot create %s\n", filename);
+  return NULL;
+}
+
+#endif
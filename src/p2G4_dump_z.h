@@ -0,0 +1,38 @@
+/*
+ * Copyright 2026 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#ifndef P2G4_DUMP_Z_H
+#define P2G4_DUMP_Z_H
+
+#include <stdio.h>
+#include "bs_types.h"
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/**
+ * Compressed (gzip) dump files
+ *
+ * Only available if the Phy was built with zlib (P2G4_HAVE_ZLIB)
+ */
+
+/**
+ * Was the Phy built with compression support
+ */
+bool dz_available(void);
+
+/**
+ * Create <filename> for writing thru a gzip compressor.
+ * The returned FILE is used and closed as any other. Everything written to
+ * it is compressed in the calling thread (the dump writer thread)
+ */
+FILE *dz_fopen(const char *filename);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
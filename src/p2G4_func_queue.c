@@ -94,6 +94,21 @@ bs_time_t fq_get_next_time(){
   return f_queue_time[next_d];
 }
 
+/**
+ * Get the time of the earliest element in the queue which does not belong to
+ * dev_nbr
+ */
+bs_time_t fq_get_next_time_others(uint32_t dev_nbr){
+  bs_time_t next_time = TIME_NEVER;
+
+  for (int i = 0; i < n_devs; i ++) {
+    if ((i != dev_nbr) && (f_queue_time[i] < next_time)) {
+      next_time = f_queue_time[i];
+    }
+  }
+  return next_time;
+}
+
 void fq_free(){
   if (f_queue_time != NULL) {
     free(f_queue_time);
@@ -73,6 +73,18 @@ bs_time_t fq_get_next_time();
  */
 void fq_call_next();
 
+/**
+ * Get the simulated time, in microseconds, of the earliest function scheduled
+ * for any other device interface than <dev_nbr>
+ *
+ * As any change in the air (or any new request from a device) can only happen
+ * as a consequence of one of those functions, this is the first time in which
+ * things may change from the point of view of <dev_nbr>.
+ *
+ * Returns TIME_NEVER if there is nothing else queued
+ */
+bs_time_t fq_get_next_time_others(uint32_t dev_nbr);
+
 /**
  * Find and update the next function which should be executed
  */
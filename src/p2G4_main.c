@@ -10,6 +10,7 @@
 #include "bs_tracing.h"
 #include "bs_oswrap.h"
 #include "bs_utils.h"
+#include "bs_results.h"
 #include "bs_pc_2G4.h"
 #include "bs_pc_2G4_utils.h"
 #include "bs_rand_main.h"
@@ -19,7 +20,14 @@
 #include "p2G4_func_queue.h"
 #include "p2G4_pending_tx_rx_list.h"
 #include "p2G4_com.h"
+#include "p2G4_com_shm.h"
+#include "p2G4_affinity.h"
 #include "p2G4_v1_v2_remap.h"
+#include "p2G4_rand.h"
+#include "p2G4_abort_sched.h"
+#include "p2G4_req_log.h"
+#include "p2G4_synth.h"
+#include "p2G4_pcapng.h"
 
 static bs_time_t current_time = 0;
 static int nbr_active_devs; //How many devices are still active (devices may disconnect during the simulation)
@@ -49,7 +57,8 @@ static void f_tx_end(uint d){
     bs_trace_raw_time(8,"Device %u - Tx done (Tx ended)\n", d);
   }
 
-  dump_tx(tx_el, d);
+  dump_tx(tx_el, txl_get_packet(d), d);
+  pcng_tx(&tx_el->tx_s, txl_get_packet(d), d);
 
   txl_clear(d);
 
@@ -78,15 +87,74 @@ static int pick_abort_tail(uint d, p2G4_abort_t *ab, const char* type) {
   return 0;
 }
 /*
- * Pick abort from device.
+ * (abort schedule)
+ * Resolve an abort reevaluation from the device pending abort schedule
+ * without contacting it
+ */
+static int pick_abort_from_schedule(uint d, p2G4_abort_t *ab, const char* type,
+                                    p2G4_power_t antenna_gain, p2G4_radioparams_t *radio_params) {
+  p2G4_rssi_power_t threshold;
+
+  asch_count_reeval(d, true);
+
+  if (asch_rssi_cond(d, &threshold)) {
+    p2G4_rssi_done_t rssi;
+    chm_RSSImeas(&tx_l_c, antenna_gain, radio_params, &rssi, d, current_time);
+    if (rssi.RSSI >= threshold) {
+      bs_trace_raw_time(8,"Device %u - %s abort schedule RSSI condition met (%.2f dBm), aborting\n",
+                        d, type, p2G4_RSSI_value_to_dBm(rssi.RSSI));
+      ab->abort_time = current_time;
+      ab->recheck_time = TIME_NEVER;
+      asch_clear(d);
+      return pick_abort_tail(d, ab, type);
+    }
+  }
+
+  asch_pop(d, ab);
+  bs_trace_raw_time(8,"Device %u - %s abort taken from the device abort schedule\n", d, type);
+  return pick_abort_tail(d, ab, type);
+}
+
+/*
+ * (abort schedule)
+ * The device responded to the abort reevaluation with a schedule:
+ * apply its first entry now, and keep the rest for the next reevaluations
+ */
+static void pick_abort_schedule(uint d, p2G4_abort_t *ab, bool rssi_allowed) {
+  p2G4_abort_sched_t sched = {0};
+  p2G4_abort_t entries[P2G4_ABORT_SCHED_MAX] = {0};
+
+  p2G4_phy_get_abort_data(d, &sched, sizeof(sched));
+  if ((sched.n_entries == 0) || (sched.n_entries > P2G4_ABORT_SCHED_MAX)) {
+    bs_trace_error_time_line("Device %u sent an abort schedule with %u entries (must be 1..%u)\n",
+                             d, sched.n_entries, P2G4_ABORT_SCHED_MAX);
+  }
+  p2G4_phy_get_abort_data(d, entries, sched.n_entries*sizeof(p2G4_abort_t));
+
+  *ab = entries[0];
+  asch_set(d, &sched, &entries[1], rssi_allowed);
+}
+
+/*
+ * Pick abort from device (or from its abort schedule).
  * if the devices terminates it returns PB_MSG_TERMINATE, if it disconencts PB_MSG_DISCONNECT
  * otherwise (everything went well, and the abort structure was updated) it returns 0
+ *
+ * <antenna_gain> and <radio_params> are only used to evaluate the RSSI
+ * condition of an abort schedule (<radio_params> is NULL for Tx, for which
+ * that condition is not allowed)
  */
-static int pick_and_validate_abort(uint d, p2G4_abort_t *ab, const char* type) {
+static int pick_and_validate_abort(uint d, p2G4_abort_t *ab, const char* type,
+                                   p2G4_power_t antenna_gain, p2G4_radioparams_t *radio_params) {
   int ret;
 
   bs_trace_raw_time(8,"Device %u - Reevaluating %s abort\n", d, type);
 
+  if (asch_pending(d)) {
+    return pick_abort_from_schedule(d, ab, type, antenna_gain, radio_params);
+  }
+  asch_count_reeval(d, false);
+
   p2G4_phy_get_new_abort_request(d);
   do {
     ret = p2G4_phy_get_new_abort_receive(d, ab);
@@ -106,6 +174,9 @@ static int pick_and_validate_abort(uint d, p2G4_abort_t *ab, const char* type) {
       p2G4_phy_get(d, &rssi_req, sizeof(rssi_req));
       chm_RSSImeas(&tx_l_c, rssi_req.antenna_gain, &rssi_req.radio_params, &rssi_resp, d, current_time);
       p2G4_phy_resp_IMRSSI(d, &rssi_resp);
+    } else if ( ret == P2G4_MSG_RERESP_ABORT_SCHED ) {
+      pick_abort_schedule(d, ab, radio_params != NULL);
+      ret = 0;
     }
   } while (ret != 0);
 
@@ -120,6 +191,8 @@ static int pick_and_validate_abort_Rxcont(uint d, p2G4_abort_t *ab) {
 
   bs_trace_raw_time(8,"Device %u - Picking abort during header eval\n", d);
 
+  asch_clear(d); //The device provides a new abort, any schedule is not valid anymore
+
   p2G4_phy_get_abort_struct(d, ab);
 
   return pick_abort_tail(d, ab, "Rx header");
@@ -232,7 +305,7 @@ static void f_tx_abort_reeval(uint d){
 
   tx_s = &tx_l_c.tx_list[d].tx_s;
 
-  if (pick_and_validate_abort(d, &(tx_s->abort), "Tx") != 0) {
+  if (pick_and_validate_abort(d, &(tx_s->abort), "Tx", 0, NULL) != 0) {
     //Device disconnected or terminated
     txl_clear(d);
     fq_remove(d);
@@ -313,7 +386,8 @@ static void f_rx_found(uint d);
 static int rx_possible_abort_recheck(uint d, rx_status_t *rx_st, bool scanning) {
   if ( current_time >= rx_st->rx_s.abort.recheck_time ) {
     int ret;
-    if ((ret = pick_and_validate_abort(d, &(rx_a[d].rx_s.abort), "Rx")) != 0) {
+    if ((ret = pick_and_validate_abort(d, &(rx_a[d].rx_s.abort), "Rx",
+                                       rx_st->rx_s.antenna_gain, &rx_st->rx_s.radio_params)) != 0) {
       return ret;
     }
     if (scanning && (rx_st->rx_s.abort.abort_time < rx_st->scan_end) ) {
@@ -397,6 +471,14 @@ static void rx_respond_done(uint d, rx_status_t *rx_status) {
   }
 }
 
+/**
+ * Release the reception reference to the packet it synchronized to (if any)
+ */
+static void rx_release_packet(rx_status_t *rx_status) {
+  p2G4_packet_unref(rx_status->packet);
+  rx_status->packet = NULL;
+}
+
 static void rx_resp_addr_found(uint d,  rx_status_t *rx_status, uint8_t *packet) {
   if ( rx_status->v1_request ) {
     p2G4_rx_done_t rx_done_v1;
@@ -496,7 +578,7 @@ static int rx_bit_error_calc(uint d, uint tx_nbr, rx_status_t *rx_st) {
 
     if ( rx_st->tx_lost
         || (tx_l_c.tx_list[tx_nbr].tx_s.coding_rate != rx_st->rx_s.coding_rate)) {
-      biterrors = bs_random_Binomial(st->errorspercalc, RAND_PROB_1/2);
+      biterrors = p2G4_rand_Binomial(d, st->errorspercalc, RAND_PROB_1/2);
     } else {
       biterrors = chm_bit_errors(&tx_l_c, tx_nbr, d, rx_st, current_time, st->errorspercalc);
     }
@@ -555,10 +637,15 @@ static void f_rx_sync(uint d){
     rx_a[d].rx_done_s.status = P2G4_RXSTATUS_INPROGRESS;
 
     bs_trace_raw_time(8,"Device %u - Sync done\n", d);
+    rx_release_packet(&rx_a[d]);
+    rx_a[d].packet = txl_get_packet(rx_a[d].tx_nbr);
+    if (rx_a[d].packet != NULL) {
+      p2G4_packet_ref(rx_a[d].packet);
+    }
     rx_resp_addr_found(d, &rx_a[d], tx_l_c.tx_list[rx_a[d].tx_nbr].packet);
 
     pc_header_t header;
-    header = p2G4_get_next_request(d);
+    header = p2G4_get_device_response(d);
     switch (header) {
     case PB_MSG_DISCONNECT:
       nbr_active_devs -= 1;
@@ -602,7 +689,9 @@ static void f_rx_sync(uint d){
         fq_add(current_time + delta, Rx_Header, d);
       }
     } else {
-      dump_rx(&rx_a[d], tx_l_c.tx_list[rx_a[d].tx_nbr].packet, d);
+      dump_rx(&rx_a[d], rx_a[d].packet, d);
+      pcng_rx(&rx_a[d], rx_a[d].packet, d);
+      rx_release_packet(&rx_a[d]);
       p2G4_handle_next_request(d);
     }
     return;
@@ -634,6 +723,7 @@ static void f_rx_header(uint d){
 
     rx_respond_done(d, &rx_a[d]);
     dump_rx(&rx_a[d],NULL,d);
+    rx_release_packet(&rx_a[d]);
     p2G4_handle_next_request(d);
     return;
   } else if ( current_time >= rx_a[d].header_end ) {
@@ -646,6 +736,76 @@ static void f_rx_header(uint d){
   }
 }
 
+/**
+ * (fast CRC statistics mode)
+ * Sample when the next bit error will happen, assuming the current BER
+ * stays constant, from a geometric distribution.
+ * <next_calc> is when the next error calculation is due
+ */
+static bs_time_t rx_sample_next_error_time(uint d, rx_status_t *rx_st, bs_time_t next_calc) {
+  rx_error_calc_state_t *st = &rx_st->err_calc_state;
+  uint tx_nbr = rx_st->tx_nbr;
+  uint32_t BER;
+  double k;
+
+  if ( rx_st->tx_lost
+      || (tx_l_c.tx_list[tx_nbr].tx_s.coding_rate != rx_st->rx_s.coding_rate)) {
+    BER = RAND_PROB_1/2;
+  } else {
+    BER = chm_BER(&tx_l_c, tx_nbr, d, rx_st, current_time);
+  }
+
+  //Number of error free calculations before the first error
+  k = p2G4_rand_trials_to_success(d, st->errorspercalc, BER);
+
+  if (k >= (double)(TIME_NEVER - next_calc)/st->rate_uspercalc) {
+    return TIME_NEVER;
+  }
+  return next_calc + (bs_time_t)k*st->rate_uspercalc;
+}
+
+/**
+ * (fast CRC statistics mode)
+ * Instead of calculating errors each microsecond, schedule the next payload
+ * event directly when the first bit error happens, or the payload ends,
+ * or when an abort recheck is due, or the BER may change (any other device
+ * has an event), whatever happens first.
+ * Once there is an error, the reception will fail, so there is no need
+ * to calculate more errors.
+ */
+static void rx_payload_schedule_fast(uint d, rx_status_t *rx_st) {
+  rx_error_calc_state_t *st = &rx_st->err_calc_state;
+  bs_time_t next_calc = current_time + st->us_to_next_calc + 1;
+  bs_time_t next_time;
+
+  next_time = BS_MIN(rx_st->payload_end, rx_st->rx_s.abort.recheck_time);
+  next_time = BS_MIN(next_time, rx_st->rx_s.abort.abort_time);
+
+  st->error_time = TIME_NEVER;
+  if (rx_st->biterrors == 0) {
+    bs_time_t others_time = fq_get_next_time_others(d);
+    bs_time_t error_time = rx_sample_next_error_time(d, rx_st, next_calc);
+
+    if ((error_time < others_time) && (error_time <= next_time)) {
+      next_time = error_time;
+      st->error_time = error_time;
+    } else {
+      next_time = BS_MIN(next_time, others_time);
+    }
+  }
+  next_time = BS_MAX(next_time, current_time + 1);
+
+  //Keep the error calculation instants aligned as if we had not skipped any
+  if (next_time <= next_calc) {
+    st->us_to_next_calc = next_calc - next_time;
+  } else {
+    uint r = (next_time - next_calc) % st->rate_uspercalc;
+    st->us_to_next_calc = r ? st->rate_uspercalc - r : 0;
+  }
+
+  fq_add(next_time, Rx_Payload, d);
+}
+
 static void f_rx_payload(uint d){
 
   if (rx_possible_abort_recheck(d, &rx_a[d], false) != 0) {
@@ -654,7 +814,14 @@ static void f_rx_payload(uint d){
     return;
   }
 
-  rx_a[d].biterrors += rx_bit_error_calc(d, rx_a[d].tx_nbr, &rx_a[d]);
+  if (current_time == rx_a[d].err_calc_state.error_time) {
+    //(fast CRC statistics mode) We already know there is an error now
+    rx_a[d].biterrors += 1;
+    rx_a[d].err_calc_state.error_time = TIME_NEVER;
+    rx_a[d].err_calc_state.us_to_next_calc = rx_a[d].err_calc_state.rate_uspercalc - 1;
+  } else {
+    rx_a[d].biterrors += rx_bit_error_calc(d, rx_a[d].tx_nbr, &rx_a[d]);
+  }
 
   if (((current_time >= rx_a[d].payload_end) && (rx_a[d].biterrors > 0))
       || (current_time >= rx_a[d].rx_s.abort.abort_time)) {
@@ -666,6 +833,7 @@ static void f_rx_payload(uint d){
     rx_a[d].rx_done_s.end_time = current_time;
     rx_respond_done(d, &rx_a[d]);
     dump_rx(&rx_a[d],NULL,d);
+    rx_release_packet(&rx_a[d]);
     p2G4_handle_next_request(d);
     return;
   } else if ( current_time >= rx_a[d].payload_end ) {
@@ -673,9 +841,14 @@ static void f_rx_payload(uint d){
     bs_trace_raw_time(8,"Device %u - RxDone (CRC ok)\n", d);
     rx_a[d].rx_done_s.end_time = current_time;
     rx_respond_done(d, &rx_a[d]);
-    dump_rx(&rx_a[d],tx_l_c.tx_list[rx_a[d].tx_nbr].packet,d);
+    dump_rx(&rx_a[d], rx_a[d].packet, d);
+    pcng_rx(&rx_a[d], rx_a[d].packet, d);
+    rx_release_packet(&rx_a[d]);
     p2G4_handle_next_request(d);
     return;
+  } else if (args.fast_crc) {
+    rx_payload_schedule_fast(d, &rx_a[d]);
+    return;
   } else {
     fq_add(current_time + 1, Rx_Payload, d);
     return;
@@ -712,14 +885,47 @@ static int find_fitting_tx_cca(p2G4_cca_t *req){
 }
 
 
+/**
+ * Account, in closed form, for all the CCA measurements which would follow the
+ * one just done, before anything could have changed in the air.
+ * (Those measurements would all be identical to this one)
+ *
+ * Only measurements strictly before any other device next event, before
+ * the next abort recheck, and before the scan end, are accounted for.
+ * As this last measurement did not trigger an early stop, identical ones
+ * would not either.
+ * Only used with time invariant channels (-cca_skip is otherwise disabled),
+ * and assumes the modem RSSI measurement is deterministic.
+ */
+static void cca_skip_unchanged_meas(uint d, cca_status_t *cca_s, double power_mW) {
+  p2G4_cca_t *req = &cca_s->req;
+  bs_time_t limit; /* First us in which a measurement may differ (or should not be done) */
+  bs_time_t n;
+
+  limit = BS_MIN(fq_get_next_time_others(d), req->abort.recheck_time);
+  limit = BS_MIN(limit, cca_s->scan_end + 1);
+
+  if (limit <= cca_s->next_meas) {
+    return;
+  }
+
+  n = (limit - cca_s->next_meas + req->scan_period - 1) / req->scan_period;
+  cca_s->RSSI_acc += n*power_mW;
+  cca_s->n_meas += n;
+  cca_s->next_meas += n*req->scan_period;
+
+  bs_trace_raw_time(9,"Device %u - CCA skipped %"PRItime" unchanged measurements\n", d, n);
+}
+
 static void f_cca_meas(uint d) {
   cca_status_t *cca_s = &cca_a[d];
   p2G4_cca_t *req = &cca_a[d].req;
   p2G4_cca_done_t *resp = &cca_a[d].resp;
   p2G4_rssi_done_t RSSI_meas;
+  double power_mW = 0;
 
   if ( current_time >= req->abort.recheck_time ) {
-    if (pick_and_validate_abort(d, &(req->abort), "CCA") != 0) {
+    if (pick_and_validate_abort(d, &(req->abort), "CCA", req->antenna_gain, &req->radio_params) != 0) {
       //Device disconnected or terminated
       fq_remove(d);
       return;
@@ -734,8 +940,8 @@ static void f_cca_meas(uint d) {
       chm_RSSImeas(&tx_l_c, req->antenna_gain, &req->radio_params, &RSSI_meas, d, current_time);
 
       double power = p2G4_RSSI_value_to_dBm(RSSI_meas.RSSI);
-      power = pow(10, power/10);
-      cca_s->RSSI_acc += power;
+      power_mW = pow(10, power/10);
+      cca_s->RSSI_acc += power_mW;
 
       resp->RSSI_max = BS_MAX(resp->RSSI_max, RSSI_meas.RSSI);
 
@@ -766,6 +972,10 @@ static void f_cca_meas(uint d) {
 
     cca_s->next_meas += req->scan_period;
     cca_s->n_meas++;
+
+    if (args.cca_skip) {
+      cca_skip_unchanged_meas(d, cca_s, power_mW);
+    }
   }
 
   if ( current_time >= cca_s->scan_end ) {
@@ -833,11 +1043,11 @@ static void check_valid_abort(p2G4_abort_t *abort, bs_time_t start_time, const c
 }
 
 static void prepare_tx_common(uint d, p2G4_txv2_t *tx_s){
-  uint8_t *data = NULL;
+  p2G4_packet_t *packet = NULL;
 
   if ( tx_s->packet_size > 0 ){
-    data = bs_malloc(tx_s->packet_size);
-    p2G4_phy_get(d, data, tx_s->packet_size);
+    packet = p2G4_packet_get(tx_s->packet_size);
+    p2G4_phy_get(d, packet->data, tx_s->packet_size);
   }
 
   PAST_CHECK(tx_s->start_tx_time, d, "Tx");
@@ -862,7 +1072,7 @@ static void prepare_tx_common(uint d, p2G4_txv2_t *tx_s){
                     tx_s->start_packet_time, tx_s->end_packet_time,
                     tx_s->abort.abort_time, tx_s->abort.recheck_time);
 
-  txl_register(d, tx_s, data);
+  txl_register(d, tx_s, packet);
 
   fq_add(tx_s->start_tx_time, Tx_Start, d);
   /* Note: It is irrelevant if an ideal packet would have started before for the Tx side,
@@ -964,7 +1174,9 @@ static void prepare_rx_common(uint d, p2G4_rxv2_t *rxv2_s){
     }
   }
 
+  rx_status->err_calc_state.error_time = TIME_NEVER;
   rx_status->tx_lost = false;
+  rx_release_packet(rx_status); //In case the previous reception did not end normally
 
   fq_add(rxv2_s->start_time, Rx_Search_start, d);
 }
@@ -1047,6 +1259,8 @@ static void prepare_CCA(uint d){
 
 static void p2G4_handle_next_request(uint d) {
   pc_header_t header;
+
+  asch_clear(d); //Any abort schedule was only valid for the previous operation
   header = p2G4_get_next_request(d);
 
   switch (header) {
@@ -1080,6 +1294,10 @@ static void p2G4_handle_next_request(uint d) {
     case P2G4_MSG_CCA_MEAS:
       prepare_CCA(d);
       break;
+    case P2G4_MSG_SHM_ATTACH:
+      p2G4_phy_shm_attach(d);
+      p2G4_handle_next_request(d);
+      break;
     default:
       bs_trace_error_time_line("The device %u has violated the protocol (%u)\n",d, header);
       break;
@@ -1090,15 +1308,23 @@ uint8_t p2G4_main_clean_up(){
   int return_error;
   bs_trace_raw(9, "main: Cleaning up...\n");
   return_error = close_dump_files();
+  pcng_close();
   if (RSSI_a != NULL)
     free(RSSI_a);
-  if (rx_a != NULL)
+  if (rx_a != NULL) {
+    for (uint d = 0; d < args.n_devs; d++) {
+      rx_release_packet(&rx_a[d]);
+    }
     free(rx_a);
+  }
   if (cca_a != NULL)
     free(cca_a);
   txl_free();
+  p2G4_packet_pool_free();
+  asch_free();
   channel_and_modem_delete();
   fq_free();
+  p2G4_rand_free();
   bs_random_free();
   p2G4_phy_disconnect_all_devices();
   p2G4_clear_args_struct(&args);
@@ -1119,10 +1345,32 @@ int main(int argc, char *argv[]) {
   p2G4_argsparse(argc, argv, &args);
 
   channel_and_modem_init(args.channel_argc, args.channel_argv, args.channel_name,
-                         args.modem_argc, args.modem_argv, args.modem_name, args.n_devs);
+                         args.modem_argc, args.modem_argv, args.modem_name, args.n_devs,
+                         args.rssi_cache, args.rssi_coherence);
+
+  if (args.cca_skip && !chm_channel_time_invariant()) {
+    bs_trace_warning_line("-cca_skip needs a time invariant channel, but channel %s is not. "
+                          "CCA measurements will not be skipped\n", args.channel_name);
+    args.cca_skip = false;
+  }
+
+  if (args.replay_file != NULL) {
+    if (args.rec_req_file != NULL) {
+      bs_trace_error_line("Cannot both record and replay device requests\n");
+    }
+    rlog_replay_open(args.replay_file, args.n_devs, p2G4_get_time);
+  } else if (args.rec_req_file != NULL) {
+    rlog_rec_open(args.rec_req_file, args.n_devs, p2G4_get_time);
+  }
+
+  synth_init(args.n_devs, args.synth_spec, args.rseed, args.sim_length_set);
 
   bs_trace_raw(7,"main: Connecting...\n");
-  p2G4_phy_initcom(args.s_id, args.p_id, args.n_devs);
+  if (args.cpu >= 0) {
+    p2G4_set_cpu_affinity(args.cpu);
+  }
+
+  p2G4_phy_initcom(args.s_id, args.p_id, args.n_devs, !args.no_shm, args.shm_spin);
 
   fq_init(args.n_devs);
   fq_register_func(Wait_Done,      f_wait_done      );
@@ -1141,12 +1389,47 @@ int main(int argc, char *argv[]) {
   fq_register_func(Rx_CCA_meas,    f_cca_meas       );
 
   bs_random_init(args.rseed);
+  p2G4_rand_init(args.n_devs, args.rseed, args.fast_rand);
   txl_create(args.n_devs);
+  asch_init(args.n_devs);
   RSSI_a = bs_calloc(args.n_devs, sizeof(p2G4_rssi_t));
   rx_a = bs_calloc(args.n_devs, sizeof(rx_status_t));
   cca_a = bs_calloc(args.n_devs, sizeof(cca_status_t));
 
-  if (args.dont_dump == 0) open_dump_files(args.compare, args.stop_on_diff, args.dump_imm, args.s_id, args.p_id, args.n_devs);
+  if (args.dont_dump == 0) {
+    p2G4_dump_cfg_t dump_cfg = {
+      .compare = args.compare,
+      .stop_on_diff = args.stop_on_diff,
+      .dump_imm = args.dump_imm,
+      .binary = args.dump_bin,
+      .digest = args.dump_digest,
+      .digest_cp = args.digest_cp,
+      .mux = args.dump_mux,
+      .compress = args.dump_compress,
+      .modemrx_sparse = args.modemrx_sparse,
+      .idx_period = args.dump_idx,
+      .filter = {
+        .devs = args.dump_devs,
+        .streams = args.dump_streams,
+        .from = args.dump_from,
+        .to = args.dump_to,
+        .freqs = args.dump_freqs,
+        .addrs = args.dump_addrs
+      },
+      .s_id = args.s_id,
+      .p_id = args.p_id,
+      .n_devs = args.n_devs
+    };
+    open_dump_files(&dump_cfg);
+  }
+
+  if (args.pcapng || (args.pcapng_live != NULL)) {
+    char *path = bs_create_result_folder(args.s_id);
+    char filename[strlen(path) + strlen(args.p_id) + 16];
+    sprintf(filename, "%s/d_%s.pcapng", path, args.p_id);
+    free(path);
+    pcng_open(args.pcapng ? filename : NULL, args.pcapng_live);
+  }
 
   nbr_active_devs = args.n_devs;
 
@@ -0,0 +1,100 @@
+/*
+ * Copyright 2026 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <stdlib.h>
+#include "bs_types.h"
+#include "bs_oswrap.h"
+#include "bs_tracing.h"
+#include "bs_utils.h"
+#include "p2G4_packet.h"
+
+static p2G4_packet_t *free_list = NULL;
+static p2G4_packet_t *all_list = NULL;
+
+static struct {
+  unsigned long long gets; //How many packets were requested
+  unsigned long long allocs; //How many packet objects were created
+  unsigned long long reallocs; //How many times a packet buffer needed to grow
+  unsigned long long hex_formats; //How many times a packet was formatted for the dumps
+  unsigned long long hex_reuses; //How many times a packet format was reused
+} pool_stats;
+
+p2G4_packet_t *p2G4_packet_get(uint size) {
+  p2G4_packet_t *packet;
+
+  pool_stats.gets++;
+
+  if (free_list != NULL) {
+    packet = free_list;
+    free_list = packet->next_free;
+  } else {
+    packet = bs_calloc(1, sizeof(p2G4_packet_t));
+    packet->next_all = all_list;
+    all_list = packet;
+    pool_stats.allocs++;
+  }
+
+  if (size > packet->data_alloc) {
+    packet->data = bs_realloc(packet->data, size);
+    packet->data_alloc = size;
+    pool_stats.reallocs++;
+  }
+  packet->size = size;
+  packet->refs = 1;
+  packet->hex_valid = false;
+  packet->next_free = NULL;
+
+  return packet;
+}
+
+void p2G4_packet_ref(p2G4_packet_t *packet) {
+  packet->refs++;
+}
+
+void p2G4_packet_unref(p2G4_packet_t *packet) {
+  if (packet == NULL) {
+    return;
+  }
+  if (packet->refs == 0) {
+    bs_trace_error_line("Programming error: packet released more times than referenced\n");
+  }
+  if (--packet->refs == 0) {
+    packet->next_free = free_list;
+    free_list = packet;
+  }
+}
+
+const char *p2G4_packet_hex(p2G4_packet_t *packet) {
+  if (packet->hex_valid) {
+    pool_stats.hex_reuses++;
+    return packet->hex;
+  }
+  size_t needed = (size_t)packet->size*3 + 1;
+  if (needed > packet->hex_alloc) {
+    packet->hex = bs_realloc(packet->hex, needed);
+    packet->hex_alloc = needed;
+  }
+  bs_hex_dump(packet->hex, packet->data, packet->size);
+  packet->hex_valid = true;
+  pool_stats.hex_formats++;
+  return packet->hex;
+}
+
+void p2G4_packet_pool_free(void) {
+  if (pool_stats.gets > 0) {
+    bs_trace_raw(3, "Packets: %llu used, %llu objects allocated, %llu buffer (re)allocations; "
+                 "dumps: %llu formatted, %llu reused\n",
+                 pool_stats.gets, pool_stats.allocs, pool_stats.reallocs,
+                 pool_stats.hex_formats, pool_stats.hex_reuses);
+  }
+  while (all_list != NULL) {
+    p2G4_packet_t *next = all_list->next_all;
+    free(all_list->data);
+    free(all_list->hex);
+    free(all_list);
+    all_list = next;
+  }
+  free_list = NULL;
+}
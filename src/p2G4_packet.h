@@ -0,0 +1,66 @@
+/*
+ * Copyright 2026 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#ifndef P2G4_PACKET_H
+#define P2G4_PACKET_H
+
+#include "bs_types.h"
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/**
+ * Reference counted transmitted packet
+ *
+ * A packet is read once from the transmitter, and then shared (by reference)
+ * by the Tx list, every receiver which synchronizes to it, and the dumps.
+ * Its hex representation (for the dumps) is formatted only once, the first
+ * time it is needed.
+ * When the last reference is released the packet object returns to a pool
+ * to be reused by a later transmission.
+ */
+typedef struct p2G4_packet_s {
+  uint refs;
+  uint size;     /* Packet size in bytes */
+  uint8_t *data;
+  size_t data_alloc; /* Allocated size of data */
+  char *hex;     /* Hex representation of the packet (if hex_valid) */
+  size_t hex_alloc;
+  bool hex_valid;
+  struct p2G4_packet_s *next_free; /* Next packet in the pool free list */
+  struct p2G4_packet_s *next_all;  /* Next packet in the list of all packets */
+} p2G4_packet_t;
+
+/**
+ * Get a packet object of <size> bytes (with one reference already taken)
+ */
+p2G4_packet_t *p2G4_packet_get(uint size);
+
+/**
+ * Take an additional reference to a packet
+ */
+void p2G4_packet_ref(p2G4_packet_t *packet);
+
+/**
+ * Release a reference to a packet (NULL is accepted and ignored)
+ */
+void p2G4_packet_unref(p2G4_packet_t *packet);
+
+/**
+ * Get the hex representation of a packet, as per bs_hex_dump()
+ */
+const char *p2G4_packet_hex(p2G4_packet_t *packet);
+
+/**
+ * Free all packets (to be called before exiting)
+ */
+void p2G4_packet_pool_free(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,299 @@
+/*
+ * Copyright 2026 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "bs_tracing.h"
+#include "bs_oswrap.h"
+#include "bs_utils.h"
+#include "bs_pc_2G4_types.h"
+#include "bs_pc_2G4_utils.h"
+#include "p2G4_pcapng.h"
+#include "p2G4_pcapng_live.h"
+
+#define BT_SHB 0x0A0D0D0A
+#define BT_IDB 0x00000001
+#define BT_EPB 0x00000006
+
+#define OPT_ENDOFOPT 0
+#define OPT_COMMENT  1
+#define OPT_IF_NAME  2
+#define OPT_IF_TSRESOL 9
+#define OPT_EPB_FLAGS 2
+
+#define EPB_FLAGS_INBOUND  1
+#define EPB_FLAGS_OUTBOUND 2
+
+#define LINKTYPE_BLE_LL_WITH_PHDR 256
+#define LINKTYPE_154_NONASK_PHY   215
+
+/* LE PHDR flags */
+#define PHDR_DEWHITENED      0x0001
+#define PHDR_SIGNAL_VALID    0x0002
+#define PHDR_REF_AA_VALID    0x0010
+#define PHDR_CRC_CHECKED     0x0400
+#define PHDR_CRC_VALID       0x0800
+#define PHDR_PHY_2M          0x4000
+
+#define PHDR_SIZE 10
+#define FILE_BUF_SIZE (1024*1024)
+
+static FILE *file = NULL;
+static bool live = false;
+
+/* Interfaces created so far (link type << 16 | center frequency) */
+static uint32_t *ifs = NULL;
+static uint n_ifs = 0, ifs_alloc = 0;
+
+/* Block being built (grown as needed) */
+static uint8_t *block = NULL;
+static size_t block_len, block_size;
+
+static const char *const status_name[] = {
+  "", "OK", "packet content error", "header error", "no sync", "in progress"
+};
+
+static void put(const void *data, size_t size) {
+  if (block_len + size > block_size) {
+    block_size = 2*(block_len + size);
+    block = bs_realloc(block, block_size);
+  }
+  memcpy(&block[block_len], data, size);
+  block_len += size;
+}
+
+static void put_u8(uint8_t v) {
+  put(&v, 1);
+}
+
+static void put_u16(uint16_t v) {
+  put(&v, 2);
+}
+
+static void put_u32(uint32_t v) {
+  put(&v, 4);
+}
+
+static void put_pad(size_t size) {
+  static const uint8_t zeroes[4] = {0};
+  put(zeroes, (4 - size % 4) % 4);
+}
+
+static void put_opt(uint16_t code, const void *data, uint16_t size) {
+  put_u16(code);
+  put_u16(size);
+  put(data, size);
+  put_pad(size);
+}
+
+/**
+ * Complete the block and pass it to the outputs
+ * (<essential> blocks, SHB and IDBs, are needed to interpret the ones after)
+ */
+static void end_block(uint32_t total_len, bool essential) {
+  put_opt(OPT_ENDOFOPT, NULL, 0);
+  put_u32(total_len);
+  if (file != NULL) {
+    fwrite(block, block_len, 1, file);
+  }
+  if (live) {
+    pcnl_block(block, block_len, essential);
+  }
+  block_len = 0;
+}
+
+static inline size_t padded(size_t size) {
+  return (size + 3) & ~(size_t)3;
+}
+
+/* Size of an option (header + value + padding) */
+static inline size_t opt_size(size_t size) {
+  return 4 + padded(size);
+}
+
+static void write_shb(void) {
+  const char app[] = "bs_2G4_phy_v1";
+  uint32_t total = 24 + opt_size(strlen(app)) + 4 + 4;
+
+  put_u32(BT_SHB);
+  put_u32(total);
+  put_u32(0x1A2B3C4D);
+  put_u16(1);
+  put_u16(0);
+  put_u32(0xFFFFFFFF); /* Section length: unknown */
+  put_u32(0xFFFFFFFF);
+  put_opt(4 /* shb_userappl */, app, strlen(app));
+  end_block(total, true);
+}
+
+static void write_idb(uint16_t link_type, p2G4_freq_t center_freq) {
+  char name[32];
+  uint8_t tsresol = 6; /* us */
+  uint32_t total;
+
+  snprintf(name, sizeof(name), "%s %.0fMHz",
+           link_type == LINKTYPE_BLE_LL_WITH_PHDR ? "BLE" : "15.4",
+           2400 + p2G4_freq_to_d(center_freq));
+  total = 16 + opt_size(strlen(name)) + opt_size(1) + 4 + 4;
+
+  put_u32(BT_IDB);
+  put_u32(total);
+  put_u16(link_type);
+  put_u16(0);
+  put_u32(0); /* No snap length limit */
+  put_opt(OPT_IF_NAME, name, strlen(name));
+  put_opt(OPT_IF_TSRESOL, &tsresol, 1);
+  end_block(total, true);
+}
+
+/**
+ * Get the interface for this link type and frequency (creating it if needed)
+ */
+static uint get_if(uint16_t link_type, p2G4_freq_t center_freq) {
+  uint32_t key = ((uint32_t)link_type << 16) | center_freq;
+
+  for (uint i = 0; i < n_ifs; i++) {
+    if (ifs[i] == key) {
+      return i;
+    }
+  }
+  if (n_ifs == ifs_alloc) {
+    ifs_alloc = ifs_alloc ? 2*ifs_alloc : 16;
+    ifs = bs_realloc(ifs, ifs_alloc * sizeof(uint32_t));
+  }
+  ifs[n_ifs] = key;
+  write_idb(link_type, center_freq);
+  return n_ifs++;
+}
+
+static inline bool is_154(p2G4_modulation_t modulation) {
+  return (modulation & P2G4_MOD_SIMILAR_MASK) == P2G4_MOD_154_250K_DSS;
+}
+
+static int8_t dBm_to_i8(double dBm) {
+  return (int8_t)BS_MAX(BS_MIN(lround(dBm), 127), -128);
+}
+
+/**
+ * Write an EPB for a packet
+ *
+ * <flags> are the LE PHDR flags, <power> the signal power, <direction> one of
+ * EPB_FLAGS_*
+ */
+static void write_epb(bs_time_t time, p2G4_radioparams_t *radio, p2G4_address_t address,
+                      const uint8_t *data, uint size, uint16_t flags, double power,
+                      uint32_t direction, const char *comment) {
+  bool ble = !is_154(radio->modulation);
+  uint16_t link_type = ble ? LINKTYPE_BLE_LL_WITH_PHDR : LINKTYPE_154_NONASK_PHY;
+  uint if_id = get_if(link_type, radio->center_freq);
+  uint32_t cap_len = size + (ble ? PHDR_SIZE + 4 : 5);
+  uint32_t total;
+
+  total = 28 + padded(cap_len) + opt_size(4) + opt_size(strlen(comment)) + 4 + 4;
+
+  put_u32(BT_EPB);
+  put_u32(total);
+  put_u32(if_id);
+  put_u32((uint64_t)time >> 32);
+  put_u32((uint32_t)time);
+  put_u32(cap_len);
+  put_u32(cap_len);
+
+  if (ble) {
+    double freq = p2G4_freq_to_d(radio->center_freq);
+    int rf_channel = (freq >= 1.0) ? (int)((freq - 1.0) / 2) : 0;
+
+    if ((radio->modulation & P2G4_MOD_SIMILAR_MASK) == P2G4_MOD_BLE2M) {
+      flags |= PHDR_PHY_2M;
+    }
+    put_u8(rf_channel);
+    put_u8((uint8_t)dBm_to_i8(power));
+    put_u8(0);  /* Noise power */
+    put_u8(0);  /* Access address offenses */
+    put_u32((uint32_t)address); /* Reference access address */
+    put_u16(flags | PHDR_DEWHITENED | PHDR_SIGNAL_VALID | PHDR_REF_AA_VALID);
+    put_u32((uint32_t)address);
+  } else {
+    put_u32(0); /* Preamble */
+    put_u8((uint8_t)address); /* SFD */
+  }
+  put(data, size);
+  put_pad(cap_len);
+
+  put_opt(OPT_EPB_FLAGS, &direction, 4);
+  put_opt(OPT_COMMENT, comment, strlen(comment));
+  end_block(total, false);
+}
+
+void pcng_open(const char *filename, const char *live_path) {
+  if (filename != NULL) {
+    file = bs_fopen(filename, "wb");
+    setvbuf(file, NULL, _IOFBF, FILE_BUF_SIZE);
+  }
+  if (live_path != NULL) {
+    pcnl_open(live_path);
+    live = true;
+  }
+  block_len = 0;
+  write_shb();
+}
+
+void pcng_tx(const p2G4_txv2_t *tx_s, const p2G4_packet_t *packet, uint dev) {
+  char comment[32];
+
+  if (((file == NULL) && !live) || (packet == NULL) || (packet->size == 0)) {
+    return;
+  }
+  p2G4_radioparams_t radio = tx_s->radio_params;
+
+  snprintf(comment, sizeof(comment), "Tx, device %u", dev);
+  write_epb(tx_s->start_packet_time, &radio, tx_s->phy_address,
+            packet->data, packet->size, 0, p2G4_power_to_d(tx_s->power_level),
+            EPB_FLAGS_OUTBOUND, comment);
+}
+
+void pcng_rx(const rx_status_t *rx_st, const p2G4_packet_t *packet, uint dev) {
+  const p2G4_rxv2_done_t *resp = &rx_st->rx_done_s;
+  char comment[96];
+  uint16_t flags = PHDR_CRC_CHECKED;
+  uint size;
+
+  if (((file == NULL) && !live) || (packet == NULL) || (resp->packet_size == 0)) {
+    return;
+  }
+  size = BS_MIN(resp->packet_size, packet->size);
+  p2G4_radioparams_t radio = rx_st->rx_s.radio_params;
+  double rssi = p2G4_RSSI_value_to_dBm(resp->rssi.RSSI);
+
+  if (resp->status == P2G4_RXSTATUS_OK) {
+    flags |= PHDR_CRC_VALID;
+  }
+  snprintf(comment, sizeof(comment), "Rx, device %u, from device %i, status %s, RSSI %.1fdBm",
+           dev, rx_st->tx_nbr,
+           resp->status < sizeof(status_name)/sizeof(status_name[0]) ? status_name[resp->status] : "?",
+           rssi);
+  write_epb(rx_st->sync_end - rx_st->rx_s.pream_and_addr_duration, &radio,
+            resp->phy_address, packet->data, size, flags, rssi,
+            EPB_FLAGS_INBOUND, comment);
+}
+
+void pcng_close(void) {
+  if (file != NULL) {
+    fclose(file);
+    file = NULL;
+  }
+  if (live) {
+    pcnl_close();
+    live = false;
+  }
+  free(block);
+  block = NULL;
+  block_size = 0;
+  free(ifs);
+  ifs = NULL;
+  n_ifs = 0;
+  ifs_alloc = 0;
+}
@@ -0,0 +1,54 @@
+/*
+ * Copyright 2026 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#ifndef P2G4_PCAPNG_H
+#define P2G4_PCAPNG_H
+
+#include "bs_types.h"
+#include "p2G4_pending_tx_rx_list.h"
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/**
+ * pcapng capture of the packets in the air
+ *
+ * As transmissions end, and as receptions of a packet complete, an Enhanced
+ * Packet Block is written, so the capture is complete when the simulation ends.
+ * BLE packets use the LINKTYPE_BLUETOOTH_LE_LL_WITH_PHDR link type (with the
+ * Tx power or the Rx RSSI as signal power, and for Rx, the CRC status), and
+ * 802.15.4 ones LINKTYPE_IEEE802_15_4_NONASK_PHY.
+ * There is one interface per link type and center frequency (created when
+ * first used). Timestamps are the simulated time (in us) when the packet
+ * starts. Each packet is annotated with its direction (Tx: outbound,
+ * Rx: inbound) and a comment with the device number (and for Rx, the status).
+ *
+ * The capture can be written into a file, and/or fed live to a reader
+ * (see p2G4_pcapng_live.h)
+ */
+
+/**
+ * Start a capture into <filename> and/or live into <live_path> (either may be NULL)
+ */
+void pcng_open(const char *filename, const char *live_path);
+
+/**
+ * A transmission has ended
+ */
+void pcng_tx(const p2G4_txv2_t *tx_s, const p2G4_packet_t *packet, uint dev);
+
+/**
+ * A reception which got (part of) a packet has ended
+ */
+void pcng_rx(const rx_status_t *rx_st, const p2G4_packet_t *packet, uint dev);
+
+void pcng_close(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
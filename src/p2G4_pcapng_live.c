@@ -0,0 +1,239 @@
+/*
+ * Copyright 2026 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <inttypes.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include "bs_types.h"
+#include "bs_tracing.h"
+#include "bs_oswrap.h"
+#include "p2G4_pcapng_live.h"
+
+/* Buffer per reader, beyond which packets are dropped for that reader */
+#define PCNL_BUF_SIZE (4*1024*1024)
+#define PCNL_MAX_READERS 8
+/* Check for new readers every this many blocks */
+#define PCNL_POLL_PERIOD 16
+
+typedef struct {
+  int fd;
+  uint8_t *buf;
+  size_t start, end; /* Pending data is buf[start..end) */
+  uint64_t dropped;
+} reader_t;
+
+static char *live_path = NULL;
+static bool fifo;
+static int listen_fd = -1;
+static reader_t readers[PCNL_MAX_READERS];
+static uint n_readers = 0;
+static uint since_poll = 0;
+
+/* Copy of the essential blocks, for readers which come later */
+static uint8_t *header = NULL;
+static size_t header_len = 0, header_size = 0;
+
+/**
+ * Non-blocking write which does not raise SIGPIPE if the reader is gone
+ */
+static ssize_t write_nb(int fd, const void *data, size_t len) {
+  if (!fifo) {
+    return send(fd, data, len, MSG_NOSIGNAL | MSG_DONTWAIT);
+  }
+
+  sigset_t pipe_set, old_set;
+  ssize_t ret;
+
+  sigemptyset(&pipe_set);
+  sigaddset(&pipe_set, SIGPIPE);
+  pthread_sigmask(SIG_BLOCK, &pipe_set, &old_set);
+  ret = write(fd, data, len);
+  if ((ret < 0) && (errno == EPIPE)) {
+    struct timespec zero = {0, 0};
+    int err = errno;
+    /* Consume the SIGPIPE now pending for this thread */
+    sigtimedwait(&pipe_set, NULL, &zero);
+    errno = err;
+  }
+  pthread_sigmask(SIG_SETMASK, &old_set, NULL);
+  return ret;
+}
+
+static void disconnect(uint i, const char *reason) {
+  reader_t *r = &readers[i];
+
+  bs_trace_raw(3, "pcapng live: reader %u disconnected (%s), %"PRIu64" packets dropped\n",
+               i, reason, r->dropped);
+  close(r->fd);
+  free(r->buf);
+  readers[i] = readers[--n_readers];
+}
+
+/**
+ * Send as much of the pending data as possible without blocking
+ * Returns false if the reader was disconnected
+ */
+static bool flush(uint i) {
+  reader_t *r = &readers[i];
+
+  while (r->start < r->end) {
+    ssize_t n = write_nb(r->fd, &r->buf[r->start], r->end - r->start);
+    if (n > 0) {
+      r->start += n;
+    } else if ((n < 0) && ((errno == EAGAIN) || (errno == EWOULDBLOCK))) {
+      return true;
+    } else if ((n < 0) && (errno == EINTR)) {
+      continue;
+    } else {
+      disconnect(i, "gone");
+      return false;
+    }
+  }
+  r->start = r->end = 0;
+  return true;
+}
+
+/**
+ * Queue a block for a reader. Returns false if the reader was disconnected
+ */
+static bool enqueue(uint i, const uint8_t *block, size_t len, bool essential) {
+  reader_t *r = &readers[i];
+
+  if (!flush(i)) {
+    return false;
+  }
+  if ((r->end + len > PCNL_BUF_SIZE) && (r->start > 0)) {
+    memmove(r->buf, &r->buf[r->start], r->end - r->start);
+    r->end -= r->start;
+    r->start = 0;
+  }
+  if (r->end + len > PCNL_BUF_SIZE) {
+    if (essential) {
+      disconnect(i, "too slow");
+      return false;
+    }
+    r->dropped++;
+    return true;
+  }
+  memcpy(&r->buf[r->end], block, len);
+  r->end += len;
+  return flush(i);
+}
+
+static void add_reader(int fd) {
+  if (n_readers == PCNL_MAX_READERS) {
+    bs_trace_warning_line("pcapng live: too many readers, refusing a new one\n");
+    close(fd);
+    return;
+  }
+  fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+  reader_t *r = &readers[n_readers++];
+  memset(r, 0, sizeof(reader_t));
+  r->fd = fd;
+  r->buf = bs_malloc(PCNL_BUF_SIZE);
+  bs_trace_raw(3, "pcapng live: reader %u connected\n", n_readers - 1);
+  enqueue(n_readers - 1, header, header_len, true);
+}
+
+static void poll_new_readers(void) {
+  if (fifo) {
+    if (n_readers == 0) {
+      int fd = open(live_path, O_WRONLY | O_NONBLOCK);
+      if (fd >= 0) { /* Otherwise there is no reader yet (ENXIO) */
+        add_reader(fd);
+      }
+    }
+    return;
+  }
+  int fd;
+  while ((fd = accept(listen_fd, NULL, NULL)) >= 0) {
+    add_reader(fd);
+  }
+}
+
+void pcnl_open(const char *path) {
+  struct stat st;
+  struct sockaddr_un addr;
+
+  live_path = bs_calloc(strlen(path) + 1, 1);
+  strcpy(live_path, path);
+
+  if (stat(path, &st) == 0) {
+    if (S_ISFIFO(st.st_mode)) {
+      fifo = true;
+      return;
+    } else if (S_ISSOCK(st.st_mode)) {
+      unlink(path);
+    } else {
+      bs_trace_error_line("pcapng live: %s exists and is neither a FIFO nor a socket\n", path);
+    }
+  }
+  fifo = false;
+
+  if (strlen(path) >= sizeof(addr.sun_path)) {
+    bs_trace_error_line("pcapng live: socket path %s too long\n", path);
+  }
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  strcpy(addr.sun_path, path);
+
+  listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if ((listen_fd < 0)
+      || (bind(listen_fd, (struct sockaddr *)&addr, sizeof(addr)) != 0)
+      || (listen(listen_fd, PCNL_MAX_READERS) != 0)) {
+    bs_trace_error_line("pcapng live: could not listen on %s (%s)\n", path, strerror(errno));
+  }
+  fcntl(listen_fd, F_SETFL, fcntl(listen_fd, F_GETFL) | O_NONBLOCK);
+  bs_trace_raw(3, "pcapng live: listening on %s\n", path);
+}
+
+void pcnl_block(const uint8_t *block, size_t len, bool essential) {
+  /*
+   * Readers accepted now are sent the essential blocks so far, and get this
+   * one below with all others, so it must not be in <header> yet
+   */
+  if (++since_poll >= PCNL_POLL_PERIOD) {
+    since_poll = 0;
+    poll_new_readers();
+  }
+
+  if (essential) {
+    if (header_len + len > header_size) {
+      header_size = 2*(header_len + len);
+      header = bs_realloc(header, header_size);
+    }
+    memcpy(&header[header_len], block, len);
+    header_len += len;
+  }
+
+  for (int i = n_readers - 1; i >= 0; i--) {
+    enqueue(i, block, len, essential);
+  }
+}
+
+void pcnl_close(void) {
+  while (n_readers > 0) {
+    if (flush(n_readers - 1)) {
+      disconnect(n_readers - 1, "end of simulation");
+    }
+  }
+  if (listen_fd >= 0) {
+    close(listen_fd);
+    listen_fd = -1;
+    unlink(live_path);
+  }
+  free(live_path);
+  live_path = NULL;
+  free(header);
+  header = NULL;
+  header_len = header_size = 0;
+}
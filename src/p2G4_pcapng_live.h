@@ -0,0 +1,46 @@
+/*
+ * Copyright 2026 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#ifndef P2G4_PCAPNG_LIVE_H
+#define P2G4_PCAPNG_LIVE_H
+
+#include <stddef.h>
+#include "bs_types.h"
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/**
+ * Live pcapng feed
+ *
+ * The pcapng blocks are streamed to readers as they are produced, either
+ * thru a FIFO (if <path> already exists and is a FIFO), or thru a Unix domain
+ * stream socket the Phy listens on at <path> (to which several readers may
+ * connect).
+ *
+ * The Phy never waits for the readers: everything is done with non-blocking
+ * calls, and each reader has a bounded buffer. When a reader falls so far
+ * behind that a packet block does not fit in its buffer, that packet is
+ * dropped for that reader (the stream stays valid, it just misses packets).
+ * Readers which connect later first get the section and interface
+ * description blocks produced so far.
+ */
+
+void pcnl_open(const char *path);
+
+/**
+ * Feed a complete block. <essential> blocks (SHB, IDBs) are never dropped
+ * (a reader which cannot take one is disconnected instead)
+ */
+void pcnl_block(const uint8_t *block, size_t len, bool essential);
+
+void pcnl_close(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -16,9 +16,15 @@ static tx_el_t *tx_list = NULL;
 static uint nbr_devs;
 static int max_tx_nbr; //highest device transmitting at this point
 
+/*
+ * Packet object of each device current Tx (tx_list[d].packet points to its data)
+ */
+static p2G4_packet_t **tx_packet = NULL;
+
 void txl_create(uint n_devs){
   tx_l_c.tx_list = bs_calloc(n_devs, sizeof(tx_el_t));
   tx_l_c.used = bs_calloc(n_devs, sizeof(uint));
+  tx_packet = bs_calloc(n_devs, sizeof(p2G4_packet_t *));
   tx_l_c.ctr = 0;
   tx_list = tx_l_c.tx_list;
   nbr_devs = n_devs;
@@ -28,12 +34,12 @@ void txl_create(uint n_devs){
 void txl_free(void){
   if ( tx_l_c.tx_list != NULL ) {
     for (int d = 0 ; d < nbr_devs; d++){
-      if ( tx_list[d].packet != NULL ) {
-        free(tx_list[d].packet);
-      }
+      p2G4_packet_unref(tx_packet[d]);
     }
+    free(tx_packet);
     free(tx_l_c.tx_list);
     free(tx_l_c.used);
+    tx_l_c.tx_list = NULL;
   }
 }
 
@@ -41,10 +47,19 @@ void txl_free(void){
  * Register a tx which has just been initiated by a device
  * Note that the tx itself does not start yet (when that happens txl_activate() should be called)
  */
-void txl_register(uint d, p2G4_txv2_t *tx_s, uint8_t* packet){
+void txl_register(uint d, p2G4_txv2_t *tx_s, p2G4_packet_t *packet){
   tx_l_c.used[d] = TXS_OFF;
   memcpy(&(tx_list[d].tx_s), tx_s, sizeof(p2G4_txv2_t) );
-  tx_list[d].packet = packet;
+  p2G4_packet_unref(tx_packet[d]);
+  tx_packet[d] = packet;
+  tx_list[d].packet = packet ? packet->data : NULL;
+}
+
+/**
+ * Get the packet object of the device <d> current Tx (or NULL if none)
+ */
+p2G4_packet_t *txl_get_packet(uint d){
+  return tx_packet[d];
 }
 
 /**
@@ -78,10 +93,9 @@ void txl_end_packet(uint d){
  */
 void txl_clear(uint d){
   tx_l_c.used[d] = TXS_OFF;
-  if (tx_list[d].packet != NULL) {
-    free(tx_list[d].packet);
-    tx_list[d].packet = NULL;
-  }
+  tx_list[d].packet = NULL;
+  p2G4_packet_unref(tx_packet[d]);
+  tx_packet[d] = NULL;
   tx_l_c.ctr++;
 
   for (int i = max_tx_nbr; i >= 0 ; i--){
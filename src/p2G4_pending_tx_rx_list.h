@@ -9,6 +9,7 @@
 #include "bs_types.h"
 #include "bs_pc_2G4_types.h"
 #include "modem_if_types.h"
+#include "p2G4_packet.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -60,9 +61,15 @@ void txl_free(void);
  *
  * @param dev_nbr Device which will transmit
  * @param tx_s Transmission parameters
- * @param packet Pointer to the transmitted packet
+ * @param packet Transmitted packet (the Tx list takes over this reference)
  */
-void txl_register(uint d, p2G4_txv2_t *tx_s, uint8_t* packet);
+void txl_register(uint d, p2G4_txv2_t *tx_s, p2G4_packet_t *packet);
+
+/**
+ * Get the packet object of a device current transmission (or NULL if none)
+ * (The caller shall take its own reference if it needs to keep it)
+ */
+p2G4_packet_t *txl_get_packet(uint dev_nbr);
 
 /**
  * Remove a transmission from the list
@@ -118,6 +125,7 @@ typedef struct {
   uint errorspercalc; //How many errors do we calculate each time that we calculate errors
   uint rate_uspercalc; //Error calculation rate, in us between calculations
   int  us_to_next_calc;
+  bs_time_t error_time; //(fast CRC statistics mode) When the next bit error will happen (TIME_NEVER if not sampled)
 } rx_error_calc_state_t;
 /**
  * Reception status (per device interface)
@@ -138,6 +146,7 @@ typedef struct {
   rx_error_calc_state_t err_calc_state;
   bool v1_request;
   bool tx_lost;
+  p2G4_packet_t *packet; //Reference to the packet we synchronized to (if any)
 } rx_status_t;
 
 /**
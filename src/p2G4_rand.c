@@ -0,0 +1,230 @@
+/*
+ * Copyright 2026 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * Random number generation for the Phy hot paths (see p2G4_rand.h)
+ *
+ * In fast mode each stream uses a set of RAND_LANES independent xoshiro128**
+ * generators, which are advanced together to refill a block of RAND_BLOCK
+ * numbers at a time (the state is kept as structure of arrays so the compiler
+ * can vectorize the refill loop).
+ *
+ * Binomial samples with n <= CDF_MAX_N (the normal case for bit error
+ * calculations) are drawn by inversion, from a cumulative distribution table
+ * which is cached per stream for the last few (n, p) pairs.
+ * As the BER of an ongoing reception rarely changes, the table is normally
+ * reused, and most samples (with no errors) cost just one comparison.
+ */
+
+#include <math.h>
+#include "bs_types.h"
+#include "bs_oswrap.h"
+#include "bs_rand_main.h"
+#include "p2G4_rand.h"
+
+#define RAND_LANES 4
+#define RAND_BLOCK 64 /* Must be a multiple of RAND_LANES */
+#define CDF_MAX_N 16
+#define CDF_CACHE_SIZE 4
+
+typedef struct {
+  uint32_t n; /* 0 = unused entry */
+  uint32_t p;
+  uint32_t thr[CDF_MAX_N]; /* thr[k] = P(X <= k) in 0..2^32 scale */
+} cdf_table_t;
+
+typedef struct {
+  uint32_t s[4][RAND_LANES];
+  uint32_t buf[RAND_BLOCK];
+  uint pos;
+  cdf_table_t cdf[CDF_CACHE_SIZE];
+  uint cdf_next; /* Next cache entry to be replaced */
+} rand_stream_t;
+
+static bool fast_mode = false;
+static uint n_streams = 0;
+static rand_stream_t *streams = NULL;
+
+static uint64_t splitmix64(uint64_t *x) {
+  uint64_t z = (*x += 0x9E3779B97F4A7C15ULL);
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  return z ^ (z >> 31);
+}
+
+static inline uint32_t rotl32(uint32_t x, int k) {
+  return (x << k) | (x >> (32 - k));
+}
+
+static void stream_refill(rand_stream_t *st) {
+  uint32_t (*s)[RAND_LANES] = st->s;
+
+  for (int i = 0; i < RAND_BLOCK; i += RAND_LANES) {
+    for (int l = 0; l < RAND_LANES; l++) {
+      uint32_t t = s[1][l] << 9;
+      st->buf[i + l] = rotl32(s[1][l] * 5, 7) * 9;
+      s[2][l] ^= s[0][l];
+      s[3][l] ^= s[1][l];
+      s[1][l] ^= s[2][l];
+      s[0][l] ^= s[3][l];
+      s[2][l] ^= t;
+      s[3][l] = rotl32(s[3][l], 11);
+    }
+  }
+  st->pos = 0;
+}
+
+static inline uint32_t stream_next(rand_stream_t *st) {
+  if (st->pos >= RAND_BLOCK) {
+    stream_refill(st);
+  }
+  return st->buf[st->pos++];
+}
+
+/* Uniform in (0,1] */
+static inline double stream_uniform(rand_stream_t *st) {
+  return (stream_next(st) + 1.0)/4294967296.0;
+}
+
+/* Convert a probability [0..1] to a threshold for a 32bit uniform number */
+static inline uint32_t prob_to_thr(double prob) {
+  if (prob >= 1.0) {
+    return UINT32_MAX;
+  }
+  return prob*4294967296.0;
+}
+
+void p2G4_rand_init(uint n_streams_i, uint seed, bool fast) {
+  fast_mode = fast;
+  n_streams = n_streams_i;
+
+  if (!fast_mode) {
+    return;
+  }
+
+  streams = bs_calloc(n_streams, sizeof(rand_stream_t));
+  for (uint i = 0; i < n_streams; i++) {
+    uint64_t x = ((uint64_t)seed << 32) ^ (i + 1) * 0xD1B54A32D192ED03ULL;
+    for (int l = 0; l < RAND_LANES; l++) {
+      uint64_t a = splitmix64(&x);
+      uint64_t b = splitmix64(&x);
+      streams[i].s[0][l] = a;
+      streams[i].s[1][l] = a >> 32;
+      streams[i].s[2][l] = b;
+      streams[i].s[3][l] = (b >> 32) | 1; /* Avoid an all 0s state */
+    }
+    streams[i].pos = RAND_BLOCK;
+  }
+}
+
+void p2G4_rand_free(void) {
+  if (streams != NULL) {
+    free(streams);
+    streams = NULL;
+  }
+}
+
+uint32_t p2G4_rand_uint32(uint stream) {
+  if (!fast_mode) {
+    return bs_random_uint32();
+  }
+  return stream_next(&streams[stream]);
+}
+
+uint p2G4_rand_Bern(uint stream, uint32_t p) {
+  if (!fast_mode) {
+    return bs_random_Bern(p);
+  }
+  uint32_t thr = prob_to_thr(p/(double)RAND_PROB_1);
+  return (thr == UINT32_MAX) || (stream_next(&streams[stream]) < thr);
+}
+
+static cdf_table_t *get_cdf_table(rand_stream_t *st, uint32_t n, uint32_t p) {
+  cdf_table_t *table;
+
+  for (int i = 0; i < CDF_CACHE_SIZE; i++) {
+    if ((st->cdf[i].n == n) && (st->cdf[i].p == p)) {
+      return &st->cdf[i];
+    }
+  }
+
+  table = &st->cdf[st->cdf_next];
+  st->cdf_next = (st->cdf_next + 1) % CDF_CACHE_SIZE;
+
+  double prob = p/(double)RAND_PROB_1;
+  double pmf = pow(1.0 - prob, n);
+  double cdf = pmf;
+  table->n = n;
+  table->p = p;
+  for (uint32_t k = 0; k < n; k++) {
+    table->thr[k] = prob_to_thr(cdf);
+    pmf *= prob/(1.0 - prob)*(n - k)/(k + 1);
+    cdf += pmf;
+  }
+  return table;
+}
+
+/* Binomial sample by sequential inversion, for bigger n */
+static uint32_t binomial_inversion(rand_stream_t *st, uint32_t n, double prob) {
+  bool flip = false;
+  if (prob > 0.5) {
+    prob = 1.0 - prob;
+    flip = true;
+  }
+  double r = prob/(1.0 - prob);
+  double pmf = pow(1.0 - prob, n);
+  double cdf = pmf;
+  double u = stream_uniform(st);
+  uint32_t k = 0;
+
+  while ((u > cdf) && (k < n)) {
+    pmf *= r*(n - k)/(k + 1);
+    k++;
+    cdf += pmf;
+  }
+  return flip ? n - k : k;
+}
+
+uint32_t p2G4_rand_Binomial(uint stream, uint32_t n, uint32_t p) {
+  if (!fast_mode) {
+    return bs_random_Binomial(n, p);
+  }
+
+  rand_stream_t *st = &streams[stream];
+
+  if ((n == 0) || (p == 0)) {
+    return 0;
+  }
+  if (p == RAND_PROB_1) {
+    return n;
+  }
+  if (n > CDF_MAX_N) {
+    return binomial_inversion(st, n, p/(double)RAND_PROB_1);
+  }
+
+  cdf_table_t *table = get_cdf_table(st, n, p);
+  uint32_t u = stream_next(st);
+  uint32_t k = 0;
+  while ((k < n) && (u >= table->thr[k])) {
+    k++;
+  }
+  return k;
+}
+
+double p2G4_rand_trials_to_success(uint stream, uint32_t n, uint32_t p) {
+  //Probability of one trial not having any success:
+  double q = pow(1.0 - p/(double)RAND_PROB_1, n);
+  double U;
+
+  if (q >= 1.0) {
+    return INFINITY;
+  } else if (q <= 0.0) {
+    return 0;
+  }
+
+  U = (p2G4_rand_uint32(stream) + 1.0)/4294967296.0; // (0,1]
+  return floor(log(U)/log(q));
+}
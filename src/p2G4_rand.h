@@ -0,0 +1,71 @@
+/*
+ * Copyright 2026 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#ifndef P2G4_RAND_H
+#define P2G4_RAND_H
+
+#include "bs_types.h"
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/**
+ * Random number generation for the Phy hot paths
+ *
+ * Each device interface has its own random stream.
+ * Unless the fast mode is enabled, these functions are just wrappers of
+ * the libRandv2 ones (and therefore produce the exact same sequence as
+ * calling those directly).
+ * In fast mode, each stream has its own generator, whose output is produced
+ * in blocks, and binomial samples for small n are drawn from cached
+ * cumulative distribution tables.
+ * The streams are seeded deterministically from the simulation seed.
+ *
+ * Probabilities are given in the same [0..RAND_PROB_1] format as for libRandv2
+ */
+
+/**
+ * Initialize the random streams
+ *
+ * @param n_streams Number of streams (one per device interface)
+ * @param seed Simulation seed
+ * @param fast Use the Phy own fast generators (true), or libRandv2 (false)
+ */
+void p2G4_rand_init(uint n_streams, uint seed, bool fast);
+
+/**
+ * Free any resources allocated by the random streams
+ */
+void p2G4_rand_free(void);
+
+/**
+ * Get a uniformly distributed 32 bit random number from a given stream
+ */
+uint32_t p2G4_rand_uint32(uint stream);
+
+/**
+ * Get a sample of a Bernoulli distribution with probability <p> of 1
+ */
+uint p2G4_rand_Bern(uint stream, uint32_t p);
+
+/**
+ * Get a sample of a Binomial distribution of <n> trials
+ * each with probability <p> of success
+ */
+uint32_t p2G4_rand_Binomial(uint stream, uint32_t n, uint32_t p);
+
+/**
+ * Get a sample of how many Binomial(<n>, <p>) trials have no success before
+ * the first one with any (geometric distribution), or INFINITY if <p> is 0.
+ * Statistically equivalent to drawing those Binomial samples one by one
+ */
+double p2G4_rand_trials_to_success(uint stream, uint32_t n, uint32_t p);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
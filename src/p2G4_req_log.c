@@ -0,0 +1,117 @@
+/*
+ * Copyright 2026 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <stdio.h>
+#include <string.h>
+#include "bs_types.h"
+#include "bs_tracing.h"
+#include "bs_oswrap.h"
+#include "p2G4_req_log.h"
+
+static FILE *rec_f = NULL;
+static FILE *replay_f = NULL;
+static bs_time_t (*get_time)(void);
+static unsigned long long n_records;
+static bool time_warned = false;
+
+static FILE *rlog_open(const char *file, const char *mode, bs_time_t (*get_time_i)(void)) {
+  FILE *f = bs_fopen(file, mode);
+  get_time = get_time_i;
+  n_records = 0;
+  return f;
+}
+
+void rlog_rec_open(const char *file, uint n_devs, bs_time_t (*get_time_i)(void)) {
+  p2G4_req_log_header_t header;
+
+  rec_f = rlog_open(file, "wb", get_time_i);
+
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, P2G4_REQ_LOG_MAGIC, sizeof(header.magic));
+  header.version = P2G4_REQ_LOG_VERSION;
+  header.n_devs = n_devs;
+  fwrite(&header, sizeof(header), 1, rec_f);
+
+  bs_trace_raw(3, "Recording device requests into %s\n", file);
+}
+
+void rlog_replay_open(const char *file, uint n_devs, bs_time_t (*get_time_i)(void)) {
+  p2G4_req_log_header_t header;
+
+  replay_f = rlog_open(file, "rb", get_time_i);
+
+  if ((fread(&header, sizeof(header), 1, replay_f) != 1)
+      || (memcmp(header.magic, P2G4_REQ_LOG_MAGIC, sizeof(header.magic)) != 0)) {
+    bs_trace_error_line("%s is not a request log\n", file);
+  }
+  if (header.version != P2G4_REQ_LOG_VERSION) {
+    bs_trace_error_line("%s request log version %u is not supported (%u expected)\n",
+                        file, header.version, P2G4_REQ_LOG_VERSION);
+  }
+  if (header.n_devs != n_devs) {
+    bs_trace_error_line("%s was recorded with %u devices, but the Phy was started with %u\n",
+                        file, header.n_devs, n_devs);
+  }
+
+  bs_trace_raw(3, "Replaying device requests from %s\n", file);
+}
+
+bool rlog_replaying(void) {
+  return replay_f != NULL;
+}
+
+void rlog_record(uint d, const void *buf, ssize_t size) {
+  p2G4_req_log_rec_t rec;
+
+  if (rec_f == NULL) {
+    return;
+  }
+  rec.time = get_time();
+  rec.dev = d;
+  rec.size = size > 0 ? size : 0;
+  fwrite(&rec, sizeof(rec), 1, rec_f);
+  fwrite(buf, rec.size, 1, rec_f);
+  n_records++;
+}
+
+ssize_t rlog_replay(uint d, void *buf, size_t size) {
+  p2G4_req_log_rec_t rec;
+
+  if (fread(&rec, sizeof(rec), 1, replay_f) != 1) {
+    bs_trace_raw_time(3, "End of request log reached (device %u)\n", d);
+    return 0;
+  }
+  n_records++;
+
+  if ((rec.dev != d) || (rec.size > size)) {
+    bs_trace_error_time_line("Replay diverged from the recording in record %llu: "
+                             "expected a read of %zu bytes from device %u, "
+                             "but the log has %u bytes from device %u (at %"PRItime")\n",
+                             n_records, size, d, rec.size, rec.dev, (bs_time_t)rec.time);
+  }
+  if ((rec.time != get_time()) && !time_warned) {
+    bs_trace_warning_time_line("Replay timing differs from the recording in record %llu "
+                               "(recorded at %"PRItime"); results may differ\n",
+                               n_records, (bs_time_t)rec.time);
+    time_warned = true;
+  }
+  if (fread(buf, 1, rec.size, replay_f) != rec.size) {
+    bs_trace_error_line("Request log truncated\n");
+  }
+  return rec.size;
+}
+
+void rlog_close(void) {
+  if (rec_f != NULL) {
+    bs_trace_raw(3, "%llu device reads recorded\n", n_records);
+    fclose(rec_f);
+    rec_f = NULL;
+  }
+  if (replay_f != NULL) {
+    bs_trace_raw(3, "%llu device reads replayed\n", n_records);
+    fclose(replay_f);
+    replay_f = NULL;
+  }
+}
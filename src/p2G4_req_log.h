@@ -0,0 +1,82 @@
+/*
+ * Copyright 2026 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#ifndef P2G4_REQ_LOG_H
+#define P2G4_REQ_LOG_H
+
+#include <sys/types.h>
+#include "bs_types.h"
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/**
+ * Device request log (recording and replay)
+ *
+ * When recording, everything the Phy reads from the devices (requests,
+ * abort reevaluation answers, etc.) is logged, in the order it is read, to a
+ * binary file:
+ *  A header (p2G4_req_log_header_t) followed by records, each being
+ *  a p2G4_req_log_rec_t followed by <size> bytes of data.
+ *
+ * When replaying, the Phy reads from the log instead of from the devices,
+ * and no device processes are needed. As the Phy is deterministic, as long
+ * as it is run with the same parameters and its behaviour is not changed,
+ * it will read exactly the same sequence of records. If it does not, the
+ * replay is stopped with an error.
+ */
+
+#define P2G4_REQ_LOG_MAGIC "P2G4RLOG"
+#define P2G4_REQ_LOG_VERSION 1
+
+typedef struct {
+  char magic[8];
+  uint32_t version;
+  uint32_t n_devs;
+} p2G4_req_log_header_t;
+
+typedef struct {
+  uint64_t time; /* Simulated time when it was read */
+  uint32_t dev; /* Device number */
+  uint32_t size; /* Number of bytes read (0 if the device was gone) */
+} p2G4_req_log_rec_t;
+
+/**
+ * Start recording into <file>
+ */
+void rlog_rec_open(const char *file, uint n_devs, bs_time_t (*get_time)(void));
+
+/**
+ * Start replaying from <file>
+ */
+void rlog_replay_open(const char *file, uint n_devs, bs_time_t (*get_time)(void));
+
+/**
+ * Are we replaying a log (instead of talking to real devices)
+ */
+bool rlog_replaying(void);
+
+/**
+ * Record <size> bytes which were just read from device <d> (if recording)
+ */
+void rlog_record(uint d, const void *buf, ssize_t size);
+
+/**
+ * Get the next <size> bytes device <d> would have sent
+ * Returns the number of bytes obtained (as the original read)
+ */
+ssize_t rlog_replay(uint d, void *buf, size_t size);
+
+/**
+ * Close the log
+ */
+void rlog_close(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
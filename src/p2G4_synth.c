@@ -0,0 +1,475 @@
+/*
+ * Copyright 2026 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Synthetic (in-process) devices (see p2G4_synth.h)
+ *
+ * Each synthetic device is a small state machine which generates its next
+ * request when the Phy asks for it, based on what the Phy last responded.
+ * As they are driven by the Phy itself, their requests are never in the past:
+ * anything which would start before the Phy last response is delayed.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "bs_types.h"
+#include "bs_tracing.h"
+#include "bs_oswrap.h"
+#include "bs_utils.h"
+#include "bs_pc_base_types.h"
+#include "bs_pc_2G4_types.h"
+#include "bs_pc_2G4_utils.h"
+#include "p2G4_synth.h"
+
+#define SYNTH_MAX_REQ 256 /* Bytes of the biggest request(s) we may have queued */
+
+/* BLE 1Mbps */
+#define SYNTH_BLE_ADV_ADDRESS 0x8E89BED6
+#define SYNTH_BLE_US_PER_BYTE 8
+#define SYNTH_BLE_OVERHEAD    8 /* Preamble (1) + access address (4) + CRC (3) bytes */
+#define SYNTH_BLE_ADV_PDU     39 /* Header (2) + AdvA (6) + AdvData (31) */
+#define SYNTH_BLE_T_IFS       150
+#define SYNTH_BLE_RX_WINDOW   32
+#define SYNTH_ADV_PERIOD      100000
+#define SYNTH_ADV_DELAY_MAX   10000
+#define SYNTH_CONN_PERIOD     7500
+
+/* 802.15.4 O-QPSK 250kbps */
+#define SYNTH_154_SFD           0xA7
+#define SYNTH_154_US_PER_BYTE   32
+#define SYNTH_154_SHR           5 /* Preamble (4) + SFD (1) bytes */
+#define SYNTH_154_PSDU          30
+#define SYNTH_154_TURNAROUND    192
+#define SYNTH_154_CCA_DURATION  128
+#define SYNTH_154_BACKOFF       320
+#define SYNTH_154_CCA_DBM       (-75)
+#define SYNTH_CSMA_MIN_BE       3
+#define SYNTH_CSMA_MAX_BE       5
+#define SYNTH_CSMA_MAX_BACKOFFS 4
+#define SYNTH_CSMA_PERIOD       10000
+
+typedef enum { SYNTH_ADV = 0, SYNTH_CONN, SYNTH_CSMA } synth_type_t;
+
+static const char *type_names[] = { "adv", "conn", "csma" };
+
+typedef struct {
+  synth_type_t type;
+  bs_time_t period;
+  bs_time_t now;         /* Time of the last Phy response (we cannot request anything before) */
+  bs_time_t event_start; /* Start of the current (or next) event */
+  uint step;             /* Next operation in the current event */
+  uint n_backoffs;       /* (csma) Backoffs done for the current frame */
+  bool cca_busy;         /* (csma) Result of the last CCA */
+  uint chan;             /* (conn) Current data channel */
+  uint hop;              /* (conn) Channel hop increment */
+  p2G4_address_t address;
+  p2G4_freq_t freq;      /* (csma) Channel frequency */
+  uint64_t rand_state;
+  bool stopping;         /* Disconnect at the next request */
+  uint8_t out[SYNTH_MAX_REQ]; /* Request(s) being read by the Phy */
+  size_t out_start;
+  size_t out_end;
+} synth_dev_t;
+
+static synth_dev_t *devs = NULL;
+static uint n_synth = 0;
+static uint first_synth = 0;
+
+static p2G4_freq_t adv_freq[3];
+static p2G4_freq_t data_freq[37];
+static p2G4_power_t tx_power;
+static p2G4_rssi_power_t cca_threshold;
+
+static struct {
+  unsigned long long tx;
+  unsigned long long rx;
+  unsigned long long cca;
+} synth_stats;
+
+static p2G4_freq_t freq_from_offset(double offset_MHz) {
+  p2G4_freq_t freq;
+
+  p2G4_freq_from_d(offset_MHz, 0, &freq);
+  return freq;
+}
+
+/**
+ * xorshift64*: each synthetic device has its own random stream, so they
+ * do not disturb the Phy random number sequences
+ */
+static uint32_t synth_rand(synth_dev_t *s) {
+  s->rand_state ^= s->rand_state >> 12;
+  s->rand_state ^= s->rand_state << 25;
+  s->rand_state ^= s->rand_state >> 27;
+  return (s->rand_state * 0x2545F4914F6CDD1DULL) >> 32;
+}
+
+static void synth_parse_spec(synth_dev_t *s, uint d, const char *spec) {
+  size_t len = strcspn(spec, ",");
+  static const bs_time_t def_period[] = { SYNTH_ADV_PERIOD, SYNTH_CONN_PERIOD, SYNTH_CSMA_PERIOD };
+  int t;
+
+  for (t = 0; t < (int)(sizeof(type_names)/sizeof(type_names[0])); t++) {
+    if ((strlen(type_names[t]) == len) && (strncmp(spec, type_names[t], len) == 0)) {
+      break;
+    }
+  }
+  if (t == sizeof(type_names)/sizeof(type_names[0])) {
+    bs_trace_error_line("Unknown synthetic device type '%.*s' for device %u (valid: adv, conn, csma)\n",
+                        (int)len, spec, d);
+  }
+  s->type = t;
+  s->period = def_period[t];
+
+  if (spec[len] == ',') {
+    char *end;
+    unsigned long long period = strtoull(&spec[len + 1], &end, 0);
+    if ((*end != 0) || (period == 0)) {
+      bs_trace_error_line("Invalid period in synthetic device %u spec '%s'\n", d, spec);
+    }
+    s->period = period;
+  }
+}
+
+uint synth_init(uint n_devs, char **specs, uint seed, bool sim_length_set) {
+  first_synth = n_devs;
+  if (specs == NULL) {
+    return n_devs;
+  }
+  for (uint d = 0; d < n_devs; d++) {
+    if (specs[d] != NULL) {
+      first_synth = d;
+      break;
+    }
+  }
+  for (uint d = first_synth; d < n_devs; d++) {
+    if (specs[d] == NULL) {
+      bs_trace_error_line("Synthetic devices must be the last devices, but device %u "
+                          "is not synthetic while device %u is\n", d, first_synth);
+    }
+  }
+  n_synth = n_devs - first_synth;
+  if (n_synth == 0) {
+    return n_devs;
+  }
+  if ((first_synth == 0) && !sim_length_set) {
+    bs_trace_error_line("All devices are synthetic, and as they never disconnect the simulation "
+                        "would not end: set its length with -sim_length\n");
+  }
+
+  for (uint i = 0; i < 3; i++) {
+    static const double adv_offset[3] = { 2, 26, 80 };
+    adv_freq[i] = freq_from_offset(adv_offset[i]);
+  }
+  for (uint ch = 0; ch < 37; ch++) {
+    data_freq[ch] = freq_from_offset(ch <= 10 ? 4 + 2*ch : 28 + 2*(ch - 11));
+  }
+  tx_power = p2G4_power_from_d(0);
+  cca_threshold = p2G4_RSSI_value_from_dBm(SYNTH_154_CCA_DBM);
+
+  devs = bs_calloc(n_synth, sizeof(synth_dev_t));
+  for (uint i = 0; i < n_synth; i++) {
+    synth_dev_t *s = &devs[i];
+    uint d = first_synth + i;
+
+    synth_parse_spec(s, d, specs[d]);
+    s->rand_state = ((uint64_t)seed << 32) ^ (0x9E3779B97F4A7C15ULL * (d + 1));
+    if (s->rand_state == 0) {
+      s->rand_state = 1;
+    }
+    /* Spread the devices first event over their period */
+    s->event_start = 1 + synth_rand(s) % s->period;
+    s->address = s->type == SYNTH_ADV ? SYNTH_BLE_ADV_ADDRESS :
+                 s->type == SYNTH_CONN ? synth_rand(s) : SYNTH_154_SFD;
+    s->chan = synth_rand(s) % 37;
+    s->hop = 5 + synth_rand(s) % 12;
+    s->freq = freq_from_offset(5 + 5*(i % 16)); /* 802.15.4 channels 11..26 */
+  }
+
+  bs_trace_raw(3, "Devices %u..%u are synthetic\n", first_synth, n_devs - 1);
+  return first_synth;
+}
+
+bool synth_is_synth(uint d) {
+  return d >= first_synth;
+}
+
+uint synth_first_dev(void) {
+  return first_synth;
+}
+
+static void push(synth_dev_t *s, const void *data, size_t size) {
+  memcpy(&s->out[s->out_end], data, size);
+  s->out_end += size;
+}
+
+static void push_header(synth_dev_t *s, pc_header_t header) {
+  push(s, &header, sizeof(header));
+}
+
+static void push_abort_never(synth_dev_t *s) {
+  p2G4_abort_t abort = { TIME_NEVER, TIME_NEVER };
+  push(s, &abort, sizeof(abort));
+}
+
+/**
+ * Earliest time, at or after <t>, we can request something for
+ */
+static bs_time_t earliest(synth_dev_t *s, bs_time_t t) {
+  return BS_MAX(t, s->now + 1);
+}
+
+static void push_tx(synth_dev_t *s, bs_time_t start, uint us_per_byte, uint overhead,
+                    p2G4_modulation_t modulation, p2G4_freq_t freq,
+                    const uint8_t *packet, uint16_t packet_size) {
+  p2G4_txv2_t tx;
+
+  memset(&tx, 0, sizeof(tx));
+  tx.start_tx_time = start;
+  tx.start_packet_time = start;
+  tx.end_packet_time = start + (overhead + packet_size) * us_per_byte - 1;
+  tx.end_tx_time = tx.end_packet_time;
+  tx.phy_address = s->address;
+  tx.radio_params.modulation = modulation;
+  tx.radio_params.center_freq = freq;
+  tx.power_level = tx_power;
+  tx.abort.abort_time = TIME_NEVER;
+  tx.abort.recheck_time = TIME_NEVER;
+  tx.packet_size = packet_size;
+
+  push_header(s, P2G4_MSG_TXV2);
+  push(s, &tx, sizeof(tx));
+  push(s, packet, packet_size);
+  synth_stats.tx++;
+}
+
+static void push_ble_rx(synth_dev_t *s, bs_time_t start, p2G4_freq_t freq) {
+  p2G4_rxv2_t rx;
+
+  memset(&rx, 0, sizeof(rx));
+  rx.start_time = start;
+  rx.scan_duration = SYNTH_BLE_RX_WINDOW + 40;
+  rx.error_calc_rate = 1000000;
+  rx.radio_params.modulation = P2G4_MOD_BLE;
+  rx.radio_params.center_freq = freq;
+  rx.pream_and_addr_duration = 40;
+  rx.header_duration = 16;
+  rx.sync_threshold = 2;
+  rx.n_addr = 1;
+  rx.abort.abort_time = TIME_NEVER;
+  rx.abort.recheck_time = TIME_NEVER;
+
+  push_header(s, P2G4_MSG_RXV2);
+  push(s, &rx, sizeof(rx));
+  push(s, &s->address, sizeof(p2G4_address_t));
+  synth_stats.rx++;
+}
+
+static void push_154_cca(synth_dev_t *s, bs_time_t start) {
+  p2G4_cca_t cca;
+
+  memset(&cca, 0, sizeof(cca));
+  cca.start_time = start;
+  cca.scan_duration = SYNTH_154_CCA_DURATION;
+  cca.scan_period = SYNTH_154_CCA_DURATION / 8;
+  cca.radio_params.modulation = P2G4_MOD_154_250K_DSS;
+  cca.radio_params.center_freq = s->freq;
+  cca.mod_threshold = cca_threshold;
+  cca.rssi_threshold = cca_threshold;
+  cca.stop_when_found = 3; /* Stop as soon as either threshold is exceeded */
+  cca.abort.abort_time = TIME_NEVER;
+  cca.abort.recheck_time = TIME_NEVER;
+
+  push_header(s, P2G4_MSG_CCA_MEAS);
+  push(s, &cca, sizeof(cca));
+  synth_stats.cca++;
+}
+
+/**
+ * Move to the next periodic event
+ */
+static void next_event(synth_dev_t *s, bs_time_t extra_delay) {
+  s->event_start = earliest(s, s->event_start + s->period + extra_delay);
+}
+
+/*
+ * Advertiser: one Tx in each of the 3 advertising channels, then the next event
+ * step: next advertising channel to use
+ */
+static void adv_next(synth_dev_t *s) {
+  uint8_t pdu[SYNTH_BLE_ADV_PDU];
+  bs_time_t start;
+
+  if (s->step == 3) {
+    s->step = 0;
+    next_event(s, synth_rand(s) % (SYNTH_ADV_DELAY_MAX + 1));
+  }
+  if (s->step == 0) {
+    start = earliest(s, s->event_start);
+  } else {
+    start = s->now + 1 + SYNTH_BLE_T_IFS;
+  }
+
+  memset(pdu, 0, sizeof(pdu));
+  pdu[0] = 0x02; /* ADV_NONCONN_IND */
+  pdu[1] = SYNTH_BLE_ADV_PDU - 2;
+  memcpy(&pdu[2], &s->rand_state, 6); /* AdvA, any value will do */
+
+  push_tx(s, start, SYNTH_BLE_US_PER_BYTE, SYNTH_BLE_OVERHEAD, P2G4_MOD_BLE,
+          adv_freq[s->step], pdu, sizeof(pdu));
+  s->step++;
+}
+
+/*
+ * Connection central: empty packet Tx in the anchor point, Rx T_IFS later,
+ * and hop to the next channel for the next event
+ * step: 0 => Tx next, 1 => Rx next, 2 => event done
+ */
+static void conn_next(synth_dev_t *s) {
+  static const uint8_t empty_pdu[2] = { 0x01, 0x00 };
+
+  if (s->step == 2) {
+    s->step = 0;
+    s->chan = (s->chan + s->hop) % 37;
+    next_event(s, 0);
+  }
+  if (s->step == 0) {
+    push_tx(s, earliest(s, s->event_start), SYNTH_BLE_US_PER_BYTE, SYNTH_BLE_OVERHEAD,
+            P2G4_MOD_BLE, data_freq[s->chan], empty_pdu, sizeof(empty_pdu));
+    s->step = 1;
+  } else {
+    push_ble_rx(s, s->now + 1 + SYNTH_BLE_T_IFS - SYNTH_BLE_RX_WINDOW/2, data_freq[s->chan]);
+    s->step = 2;
+  }
+}
+
+/*
+ * 802.15.4 unslotted CSMA-CA: random backoff, CCA, and if the channel was
+ * clear Tx. If it was busy, retry with a bigger backoff up to the maximum
+ * number of backoffs, after which the frame is dropped.
+ * step: 0 => start a new frame, 1 => CCA done, 2 => Tx done
+ */
+static void csma_next(synth_dev_t *s) {
+  uint be;
+
+  if (s->step == 1) {
+    if (!s->cca_busy) {
+      uint8_t frame[1 + SYNTH_154_PSDU];
+
+      memset(frame, 0, sizeof(frame));
+      frame[0] = SYNTH_154_PSDU; /* PHR */
+      push_tx(s, s->now + 1 + SYNTH_154_TURNAROUND, SYNTH_154_US_PER_BYTE, SYNTH_154_SHR,
+              P2G4_MOD_154_250K_DSS, s->freq, frame, sizeof(frame));
+      s->step = 2;
+      return;
+    }
+    if (s->n_backoffs < SYNTH_CSMA_MAX_BACKOFFS) {
+      s->n_backoffs++;
+      be = BS_MIN(SYNTH_CSMA_MIN_BE + s->n_backoffs, SYNTH_CSMA_MAX_BE);
+      push_154_cca(s, s->now + 1 + (synth_rand(s) % (1 << be)) * SYNTH_154_BACKOFF);
+      return;
+    }
+    /* Channel access failure, we drop this frame */
+  }
+  if (s->step != 0) {
+    next_event(s, 0);
+  }
+  s->n_backoffs = 0;
+  be = SYNTH_CSMA_MIN_BE;
+  push_154_cca(s, earliest(s, s->event_start + (synth_rand(s) % (1 << be)) * SYNTH_154_BACKOFF));
+  s->step = 1;
+}
+
+ssize_t synth_read(uint d, void *buf, size_t size) {
+  synth_dev_t *s = &devs[d - first_synth];
+
+  if (s->out_start == s->out_end) {
+    s->out_start = 0;
+    s->out_end = 0;
+    if (s->stopping) {
+      push_header(s, PB_MSG_DISCONNECT);
+    } else if (s->type == SYNTH_ADV) {
+      adv_next(s);
+    } else if (s->type == SYNTH_CONN) {
+      conn_next(s);
+    } else {
+      csma_next(s);
+    }
+  }
+
+  if (s->out_end - s->out_start < size) {
+    bs_trace_error_line("Phy tried to read %zu bytes from synthetic device %u, but only %zu are pending\n",
+                        size, d, s->out_end - s->out_start);
+  }
+  memcpy(buf, &s->out[s->out_start], size);
+  s->out_start += size;
+  return size;
+}
+
+void synth_receive(uint d, const void *buf, size_t size) {
+  synth_dev_t *s = &devs[d - first_synth];
+  const uint8_t *content = (const uint8_t *)buf + sizeof(pc_header_t);
+  pc_header_t header;
+
+  memcpy(&header, buf, sizeof(header));
+
+  switch (header) {
+  case P2G4_MSG_TX_END: {
+    p2G4_tx_done_t done;
+    memcpy(&done, content, sizeof(done));
+    s->now = done.end_time;
+    break;
+  }
+  case P2G4_MSG_RXV2_ADDRESSFOUND: {
+    p2G4_rxv2_done_t done;
+    memcpy(&done, content, sizeof(done));
+    s->now = done.end_time;
+    /* We are not interested in the content */
+    push_header(s, P2G4_MSG_RXSTOP);
+    break;
+  }
+  case P2G4_MSG_RXV2_END: {
+    p2G4_rxv2_done_t done;
+    memcpy(&done, content, sizeof(done));
+    s->now = done.end_time;
+    break;
+  }
+  case P2G4_MSG_CCA_END: {
+    p2G4_cca_done_t done;
+    memcpy(&done, content, sizeof(done));
+    s->now = done.end_time;
+    s->cca_busy = done.mod_found || done.rssi_overthreshold;
+    break;
+  }
+  case P2G4_MSG_ABORTREEVAL:
+    /* We never ask for reevaluations, but if we are asked, we do not abort */
+    push_header(s, P2G4_MSG_RERESP_ABORTREEVAL);
+    push_abort_never(s);
+    break;
+  case PB_MSG_WAIT_END:
+  case PB_MSG_DISCONNECT:
+    break;
+  default:
+    bs_trace_error_line("Synthetic device %u received an unexpected message (%u)\n", d, header);
+    break;
+  }
+}
+
+void synth_stop_all(void) {
+  for (uint i = 0; i < n_synth; i++) {
+    devs[i].stopping = true;
+  }
+}
+
+void synth_free(void) {
+  if (devs == NULL) {
+    return;
+  }
+  bs_trace_raw(3, "Synthetic devices: %llu Tx, %llu Rx and %llu CCA requests generated\n",
+               synth_stats.tx, synth_stats.rx, synth_stats.cca);
+  free(devs);
+  devs = NULL;
+}
@@ -0,0 +1,89 @@
+/*
+ * Copyright 2026 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#ifndef P2G4_SYNTH_H
+#define P2G4_SYNTH_H
+
+#include <sys/types.h>
+#include "bs_types.h"
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/**
+ * Synthetic (in-process) devices
+ *
+ * A synthetic device lives inside the Phy: instead of reading its requests
+ * from a FIFO, the communication layer asks it to produce them
+ * (synth_read()), and instead of writing the responses to a FIFO it hands
+ * them to it (synth_receive()). Otherwise the Phy handles them exactly as
+ * any other device.
+ *
+ * They are meant as cheap background traffic/interferers, and as load
+ * drivers to benchmark the Phy with many devices.
+ *
+ * Each synthetic device is configured with a spec string
+ * "<type>[,<period_us>]" where <type> is one of:
+ *  adv : BLE 1Mbps advertiser (non-connectable advertising events
+ *        on channels 37, 38 & 39), default period 100ms (+0..10ms random delay)
+ *  conn: BLE 1Mbps connection central (empty packet Tx, followed
+ *        by a short Rx, on a hopping data channel), default period 7.5ms
+ *  csma: 802.15.4 (O-QPSK 250kbps) unslotted CSMA-CA sender (CCA, random
+ *        backoff, and Tx of a 30 byte frame), default period 10ms
+ *
+ * Synthetic devices must be the last devices (highest device numbers).
+ */
+
+/**
+ * Initialize the synthetic devices
+ *
+ * @param n_devs Total number of devices
+ * @param specs Array of n_devs spec strings (NULL for real devices), or NULL if none
+ * @param seed Random seed (each synthetic device uses its own random stream)
+ * @param sim_length_set The simulation length was set: as synthetic devices
+ *        never disconnect, it is required if there are no real devices
+ *
+ * Returns the number of real devices
+ */
+uint synth_init(uint n_devs, char **specs, uint seed, bool sim_length_set);
+
+/**
+ * Is device <d> a synthetic device
+ */
+bool synth_is_synth(uint d);
+
+/**
+ * First synthetic device number (== total number of devices if none)
+ */
+uint synth_first_dev(void);
+
+/**
+ * Get the next <size> bytes the synthetic device <d> sends to the Phy
+ * Returns the number of bytes obtained
+ */
+ssize_t synth_read(uint d, void *buf, size_t size);
+
+/**
+ * Hand a message (a header and its content) the Phy sent to the synthetic device <d>
+ */
+void synth_receive(uint d, const void *buf, size_t size);
+
+/**
+ * All real devices are gone: make all synthetic devices disconnect
+ * at their next request
+ */
+void synth_stop_all(void);
+
+/**
+ * Free all synthetic devices resources
+ */
+void synth_free(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
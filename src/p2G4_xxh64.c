@@ -0,0 +1,128 @@
+/*
+ * Copyright 2026 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * XXH64 (see https://github.com/Cyan4973/xxHash/blob/dev/doc/xxhash_spec.md)
+ * Little endian hosts only (as the rest of the Phy dumps)
+ */
+
+#include <string.h>
+#include "p2G4_xxh64.h"
+
+#define P1 0x9E3779B185EBCA87ULL
+#define P2 0xC2B2AE3D27D4EB4FULL
+#define P3 0x165667B19E3779F9ULL
+#define P4 0x85EBCA77C2B2AE63ULL
+#define P5 0x27D4EB2F165667C5ULL
+
+static inline uint64_t rotl(uint64_t x, int r) {
+  return (x << r) | (x >> (64 - r));
+}
+
+static inline uint64_t read64(const uint8_t *p) {
+  uint64_t v;
+  memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+static inline uint32_t read32(const uint8_t *p) {
+  uint32_t v;
+  memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+static inline uint64_t round64(uint64_t acc, uint64_t input) {
+  acc += input * P2;
+  acc = rotl(acc, 31);
+  return acc * P1;
+}
+
+static inline uint64_t merge_round(uint64_t acc, uint64_t val) {
+  acc ^= round64(0, val);
+  return acc * P1 + P4;
+}
+
+void p2G4_xxh64_reset(p2G4_xxh64_t *s, uint64_t seed) {
+  memset(s, 0, sizeof(*s));
+  s->seed = seed;
+  s->v[0] = seed + P1 + P2;
+  s->v[1] = seed + P2;
+  s->v[2] = seed;
+  s->v[3] = seed - P1;
+}
+
+static inline void consume_stripe(p2G4_xxh64_t *s, const uint8_t *p) {
+  s->v[0] = round64(s->v[0], read64(p));
+  s->v[1] = round64(s->v[1], read64(p + 8));
+  s->v[2] = round64(s->v[2], read64(p + 16));
+  s->v[3] = round64(s->v[3], read64(p + 24));
+}
+
+void p2G4_xxh64_update(p2G4_xxh64_t *s, const void *data, size_t len) {
+  const uint8_t *p = data;
+  const uint8_t *end = p + len;
+
+  s->total_len += len;
+
+  if (s->mem_size + len < 32) {
+    memcpy(&s->mem[s->mem_size], p, len);
+    s->mem_size += len;
+    return;
+  }
+  if (s->mem_size > 0) {
+    memcpy(&s->mem[s->mem_size], p, 32 - s->mem_size);
+    p += 32 - s->mem_size;
+    consume_stripe(s, s->mem);
+    s->mem_size = 0;
+  }
+  while (p + 32 <= end) {
+    consume_stripe(s, p);
+    p += 32;
+  }
+  if (p < end) {
+    memcpy(s->mem, p, end - p);
+    s->mem_size = end - p;
+  }
+}
+
+uint64_t p2G4_xxh64_digest(const p2G4_xxh64_t *s) {
+  const uint8_t *p = s->mem;
+  const uint8_t *end = p + s->mem_size;
+  uint64_t h;
+
+  if (s->total_len >= 32) {
+    h = rotl(s->v[0], 1) + rotl(s->v[1], 7) + rotl(s->v[2], 12) + rotl(s->v[3], 18);
+    for (int i = 0; i < 4; i++) {
+      h = merge_round(h, s->v[i]);
+    }
+  } else {
+    h = s->seed + P5;
+  }
+  h += s->total_len;
+
+  while (p + 8 <= end) {
+    h ^= round64(0, read64(p));
+    h = rotl(h, 27) * P1 + P4;
+    p += 8;
+  }
+  if (p + 4 <= end) {
+    h ^= (uint64_t)read32(p) * P1;
+    h = rotl(h, 23) * P2 + P3;
+    p += 4;
+  }
+  while (p < end) {
+    h ^= (*p) * P5;
+    h = rotl(h, 11) * P1;
+    p++;
+  }
+
+  h ^= h >> 33;
+  h *= P2;
+  h ^= h >> 29;
+  h *= P3;
+  h ^= h >> 32;
+  return h;
+}
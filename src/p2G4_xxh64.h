@@ -0,0 +1,39 @@
+/*
+ * Copyright 2026 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#ifndef P2G4_XXH64_H
+#define P2G4_XXH64_H
+
+#include <stddef.h>
+#include "bs_types.h"
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/**
+ * Streaming XXH64 hash (compatible with the reference xxHash XXH64)
+ */
+typedef struct {
+  uint64_t v[4];
+  uint64_t total_len;
+  uint8_t mem[32];
+  uint32_t mem_size;
+  uint64_t seed;
+} p2G4_xxh64_t;
+
+void p2G4_xxh64_reset(p2G4_xxh64_t *s, uint64_t seed);
+void p2G4_xxh64_update(p2G4_xxh64_t *s, const void *data, size_t len);
+/**
+ * Digest of everything hashed so far (the state is not modified, so more can
+ * be added after)
+ */
+uint64_t p2G4_xxh64_digest(const p2G4_xxh64_t *s);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,74 @@
+/*
+ * Copyright 2026 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * Check how abort schedules (P2G4_MSG_RERESP_ABORT_SCHED) are stored:
+ *  * The entries after the first one are applied in order, and then the
+ *    schedule is exhausted
+ *  * An RSSI condition is kept for Rx and CCA schedules, but dropped for
+ *    schedules sent during a Tx (a device can not measure its own RSSI while
+ *    it transmits)
+ *
+ * Usage: p2G4_abort_sched_test (returns 0 if all checks pass)
+ */
+#include <stdio.h>
+#include "bs_types.h"
+#include "p2G4_abort_sched.h"
+
+#define N_ENTRIES 4
+
+static bool ok = true;
+
+static void expect(bool cond, const char *what) {
+  printf("%-60s %s\n", what, cond ? "ok" : "FAIL");
+  ok &= cond;
+}
+
+/* Send a schedule with an RSSI condition, as if during a Tx or not */
+static void send_sched(uint d, bool tx) {
+  p2G4_abort_sched_t s;
+  p2G4_abort_t entries[N_ENTRIES];
+
+  s.n_entries = N_ENTRIES;
+  s.flags = P2G4_ABORT_SCHED_RSSI_COND;
+  s.rssi_threshold = -50;
+  for (uint i = 0; i < N_ENTRIES; i++) {
+    entries[i].abort_time = TIME_NEVER;
+    entries[i].recheck_time = 100*(i + 1);
+  }
+  /* As the Phy does: the first entry is applied directly */
+  asch_set(d, &s, &entries[1], !tx);
+}
+
+int main(void) {
+  p2G4_rssi_power_t threshold = 0;
+  p2G4_abort_t ab;
+  bool in_order = true;
+
+  asch_init(2);
+
+  send_sched(0, false);
+  expect(asch_rssi_cond(0, &threshold) && (threshold == -50),
+         "Rx schedule keeps its RSSI condition");
+
+  send_sched(1, true);
+  expect(!asch_rssi_cond(1, &threshold), "Tx schedule RSSI condition is dropped");
+
+  for (uint i = 1; i < N_ENTRIES; i++) {
+    in_order &= asch_pending(1);
+    asch_pop(1, &ab);
+    in_order &= (ab.recheck_time == 100*(i + 1));
+  }
+  expect(in_order && !asch_pending(1), "Tx schedule entries are still applied in order");
+
+  asch_clear(0);
+  expect(!asch_pending(0), "A cleared schedule has no pending entries");
+
+  asch_free();
+
+  printf("%s\n", ok ? "PASS" : "FAIL");
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,124 @@
+/*
+ * Copyright 2026 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * Check that the fast CRC statistics mode (-fast_crc) gives the same packet
+ * error rate as calculating the bit errors on every error calculation.
+ *
+ * For a sweep of BERs (chosen to give PERs from 1% to 99%), and for 1 and 2
+ * bits per error calculation, many payloads are simulated both ways:
+ *  * per calculation: a Binomial(bits per calc, BER) sample for each error
+ *    calculation, as in the normal mode
+ *  * fast: sampling how many calculations there are until the first error
+ *    (p2G4_rand_trials_to_success(), as rx_sample_next_error_time() does),
+ *    either once for the whole payload, or resampling it on boundaries while
+ *    the BER changes midway (as when other devices have events)
+ * and the PERs must agree within the statistical tolerance.
+ *
+ * Usage: p2G4_fast_crc_per_test (returns 0 if all checks pass)
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "bs_types.h"
+#include "bs_utils.h"
+#include "bs_rand_main.h"
+#include "p2G4_rand.h"
+
+#define N_PACKETS 20000
+#define PAYLOAD_CALCS 1000
+/* When resampling, every this many calculations (and when the BER changes) */
+#define RESAMPLE_PERIOD 37
+/* Allowed difference, in standard deviations of the difference of the PERs */
+#define N_SIGMAS 4.5
+
+#define STREAM_PER_CALC 0
+#define STREAM_FAST 1
+
+static const double target_PERs[] = { 0.01, 0.1, 0.5, 0.9, 0.99 };
+static const uint bits_per_calc[] = { 1, 2 };
+
+/* BER during calculation <c>: <BER> for the first half, <BER2> for the second */
+static inline uint32_t ber_at(uint c, uint32_t BER, uint32_t BER2) {
+  return (c < PAYLOAD_CALCS/2) ? BER : BER2;
+}
+
+/* Is a payload received with errors, calculating errors on each calculation */
+static bool per_calc_error(uint n, uint32_t BER, uint32_t BER2) {
+  for (uint c = 0; c < PAYLOAD_CALCS; c++) {
+    if (p2G4_rand_Binomial(STREAM_PER_CALC, n, ber_at(c, BER, BER2)) > 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/*
+ * Is a payload received with errors, sampling the first error time,
+ * and resampling it every <period> calculations and when the BER changes
+ */
+static bool fast_error(uint n, uint32_t BER, uint32_t BER2, uint period) {
+  uint c = 0;
+
+  while (c < PAYLOAD_CALCS) {
+    uint end = c + period;
+    if ((c < PAYLOAD_CALCS/2) && (end > PAYLOAD_CALCS/2)) {
+      end = PAYLOAD_CALCS/2;
+    }
+    end = BS_MIN(end, PAYLOAD_CALCS);
+
+    double k = p2G4_rand_trials_to_success(STREAM_FAST, n, ber_at(c, BER, BER2));
+    if (c + k < end) {
+      return true;
+    }
+    c = end;
+  }
+  return false;
+}
+
+static bool check(const char *scenario, uint n, uint32_t BER, uint32_t BER2, uint period) {
+  uint err_calc = 0, err_fast = 0;
+
+  for (uint i = 0; i < N_PACKETS; i++) {
+    err_calc += per_calc_error(n, BER, BER2);
+    err_fast += fast_error(n, BER, BER2, period);
+  }
+
+  double per_calc = err_calc/(double)N_PACKETS;
+  double per_fast = err_fast/(double)N_PACKETS;
+  double per = (per_calc + per_fast)/2;
+  double sigma = sqrt(2*per*(1 - per)/N_PACKETS);
+  double tolerance = N_SIGMAS*sigma + 1.0/N_PACKETS;
+  bool ok = fabs(per_calc - per_fast) <= tolerance;
+
+  printf("%-9s %u bit(s)/calc BER %.3e: PER per calc %.4f, fast %.4f (+-%.4f) %s\n",
+         scenario, n, BER/(double)RAND_PROB_1, per_calc, per_fast, tolerance,
+         ok ? "ok" : "FAIL");
+  return ok;
+}
+
+int main(void) {
+  bool ok = true;
+
+  p2G4_rand_init(2, 0x1234, true);
+
+  for (uint b = 0; b < sizeof(bits_per_calc)/sizeof(bits_per_calc[0]); b++) {
+    uint n = bits_per_calc[b];
+    for (uint p = 0; p < sizeof(target_PERs)/sizeof(target_PERs[0]); p++) {
+      double ber = 1.0 - pow(1.0 - target_PERs[p], 1.0/(n*PAYLOAD_CALCS));
+      uint32_t BER = ber*RAND_PROB_1;
+
+      ok &= check("constant", n, BER, BER, PAYLOAD_CALCS);
+      /* The BER halves midway */
+      ok &= check("changing", n, BER, BER/2, RESAMPLE_PERIOD);
+    }
+  }
+
+  p2G4_rand_free();
+
+  printf("%s\n", ok ? "PASS" : "FAIL");
+  return ok ? 0 : 1;
+}